@@ -382,3 +382,54 @@ int Addsynth::load (const char* sdir)
       f.close();
       return 0;
       }
+
+//---------------------------------------------------------
+//   checksum
+//    FNV-1a hash of everything the generated waves depend
+//    on, stored with the wave cache files
+//---------------------------------------------------------
+
+static void hashBytes (uint32_t& h, const void* p, size_t n)
+      {
+      const unsigned char* c = static_cast<const unsigned char*>(p);
+      for (size_t i = 0; i < n; ++i) {
+            h ^= c[i];
+            h *= 16777619u;
+            }
+      }
+
+static void hashFunc (uint32_t& h, const N_func& f)
+      {
+      for (int i = 0; i < N_NOTE; ++i) {
+            float v = f.vs (i);
+            int   s = f.st (i);
+            hashBytes (h, &v, sizeof(v));
+            hashBytes (h, &s, sizeof(s));
+            }
+      }
+
+static void hashFunc (uint32_t& h, const HN_func& f)
+      {
+      for (int k = 0; k < N_HARM; ++k) {
+            for (int i = 0; i < N_NOTE; ++i) {
+                  float v = f.vs (k, i);
+                  int   s = f.st (k, i);
+                  hashBytes (h, &v, sizeof(v));
+                  hashBytes (h, &s, sizeof(s));
+                  }
+            }
+      }
+
+uint32_t Addsynth::checksum() const
+      {
+      uint32_t h = 2166136261u;
+      hashBytes (h, &_n0, sizeof(_n0));
+      hashBytes (h, &_n1, sizeof(_n1));
+      hashBytes (h, &_fn, sizeof(_fn));
+      hashBytes (h, &_fd, sizeof(_fd));
+      for (const N_func* f : { &_n_vol, &_n_off, &_n_ran, &_n_ins, &_n_att, &_n_atd, &_n_dct, &_n_dcd })
+            hashFunc (h, *f);
+      for (const HN_func* f : { &_h_lev, &_h_ran, &_h_att, &_h_atp })
+            hashFunc (h, *f);
+      return h;
+      }
@@ -90,6 +90,7 @@ class Addsynth
       void reset();
       int save (const char *sdir);
       int load (const char *sdir);
+      uint32_t checksum() const;
 
       char       _filename [64];
       char       _stopname [32];
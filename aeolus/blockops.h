@@ -0,0 +1,112 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __BLOCKOPS_H__
+#define __BLOCKOPS_H__
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AEOLUS_SSE
+#endif
+
+//---------------------------------------------------------
+//   block kernels used by Pipewave::play() and
+//   Division::process()
+//
+//    Gains and interpolation positions advance linearly
+//    over the block: the value for sample i is x + i * dx.
+//    Source and destination need not be aligned.
+//---------------------------------------------------------
+
+namespace AeolusBlock {
+
+//---------------------------------------------------------
+//   add
+//    q[i] += p[i]
+//---------------------------------------------------------
+
+inline void add(float* q, const float* p, int n)
+      {
+      int i = 0;
+#ifdef AEOLUS_SSE
+      for (; i + 4 <= n; i += 4)
+            _mm_storeu_ps(q + i, _mm_add_ps(_mm_loadu_ps(q + i), _mm_loadu_ps(p + i)));
+#endif
+      for (; i < n; ++i)
+            q[i] += p[i];
+      }
+
+//---------------------------------------------------------
+//   addRamp
+//    q[i] += (g - i * dg) * p[i]
+//---------------------------------------------------------
+
+inline void addRamp(float* q, const float* p, int n, float g, float dg)
+      {
+      int i = 0;
+#ifdef AEOLUS_SSE
+      if (n >= 4) {
+            __m128 gv = _mm_setr_ps(g, g - dg, g - 2 * dg, g - 3 * dg);
+            __m128 gs = _mm_set1_ps(4 * dg);
+            for (; i + 4 <= n; i += 4) {
+                  __m128 s = _mm_mul_ps(gv, _mm_loadu_ps(p + i));
+                  _mm_storeu_ps(q + i, _mm_add_ps(_mm_loadu_ps(q + i), s));
+                  gv = _mm_sub_ps(gv, gs);
+                  }
+            }
+#endif
+      for (; i < n; ++i)
+            q[i] += (g - i * dg) * p[i];
+      }
+
+//---------------------------------------------------------
+//   addInterp
+//    q[i] += (g - i * dg) * (p[i] + y_i * (p[i + 1] - p[i]))
+//    with y_i = y + i * dy; reads p[0] .. p[n]
+//---------------------------------------------------------
+
+inline void addInterp(float* q, const float* p, int n, float y, float dy, float g, float dg)
+      {
+      int i = 0;
+#ifdef AEOLUS_SSE
+      if (n >= 4) {
+            __m128 yv = _mm_setr_ps(y, y + dy, y + 2 * dy, y + 3 * dy);
+            __m128 ys = _mm_set1_ps(4 * dy);
+            __m128 gv = _mm_setr_ps(g, g - dg, g - 2 * dg, g - 3 * dg);
+            __m128 gs = _mm_set1_ps(4 * dg);
+            for (; i + 4 <= n; i += 4) {
+                  __m128 a = _mm_loadu_ps(p + i);
+                  __m128 b = _mm_loadu_ps(p + i + 1);
+                  __m128 s = _mm_add_ps(a, _mm_mul_ps(yv, _mm_sub_ps(b, a)));
+                  _mm_storeu_ps(q + i, _mm_add_ps(_mm_loadu_ps(q + i), _mm_mul_ps(gv, s)));
+                  yv = _mm_add_ps(yv, ys);
+                  gv = _mm_sub_ps(gv, gs);
+                  }
+            }
+#endif
+      for (; i < n; ++i)
+            q[i] += (g - i * dg) * (p[i] + (y + i * dy) * (p[i + 1] - p[i]));
+      }
+
+//---------------------------------------------------------
+//   mixRamp
+//    q[i] += (g + (i + 1) * d) * p[i]
+//---------------------------------------------------------
+
+inline void mixRamp(float* q, const float* p, int n, float g, float d)
+      {
+      addRamp(q, p, n, g + d, -d);
+      }
+
+}     // namespace AeolusBlock
+
+#endif
@@ -18,6 +18,7 @@
 
 
 #include "division.h"
+#include "blockops.h"
 
 //---------------------------------------------------------
 //   Division
@@ -77,19 +78,10 @@ void Division::process()
             g = t;
 
       float d  = (g - _gain) / PERIOD;
-      g        = _gain;
-      float* p = _buff;
       float* q = _asect->get_wptr ();
 
-      for (int i = 0; i < PERIOD; i++) {
-            g += d;
-            q [0 * PERIOD * MIXLEN] += p [0 * PERIOD] * g;
-            q [1 * PERIOD * MIXLEN] += p [1 * PERIOD] * g;
-            q [2 * PERIOD * MIXLEN] += p [2 * PERIOD] * g;
-            q [3 * PERIOD * MIXLEN] += p [3 * PERIOD] * g;
-            p++;
-            q++;
-            }
+      for (int c = 0; c < NCHANN; c++)
+            AeolusBlock::mixRamp (q + c * PERIOD * MIXLEN, _buff + c * PERIOD, PERIOD, _gain, d);
       _gain = g;
       }
 
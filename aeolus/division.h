@@ -41,7 +41,7 @@ class Division
       float      _c;
       float      _s;
       float      _m;
-      float      _buff [NCHANN * PERIOD];
+      alignas(16) float _buff [NCHANN * PERIOD];
 
    public:
       Division (Asection *asect, float fsam);
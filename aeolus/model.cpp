@@ -156,16 +156,64 @@ void Model::init_iface()
       set_mconf (0, _chconf[0]._bits);
       }
 
+//---------------------------------------------------------
+//   init_ranks
+//    Waves of different ranks are loaded or generated in
+//    parallel, they are handed to the divisions afterwards
+//    in rank order.
+//---------------------------------------------------------
+
 void Model::init_ranks (int comm)
       {
       _count++;
       _ready = false;
 //WS      send_event (TO_IFACE, new M_ifc_retune (_fbase, _itemp));
 
+      if (comm == MT_SAVE_RANK) {
+            for (int g = 0; g < _ngroup; g++) {
+                  Group* G = _group + g;
+                  for (int i = 0; i < G->_nifelm; i++)
+                        proc_rank (g, i, comm);
+                  }
+            _ready = true;
+            return;
+            }
+
+      struct RankJob {
+            int d;
+            int r;
+            Addsynth* sdef;
+            Rankwave* wave;
+            };
+      QList<RankJob> jobs;
       for (int g = 0; g < _ngroup; g++) {
             Group* G = _group + g;
-            for (int i = 0; i < G->_nifelm; i++)
-                  proc_rank (g, i, comm);
+            for (int i = 0; i < G->_nifelm; i++) {
+                  Ifelm* I = G->_ifelms + i;
+                  if ((I->_type != Ifelm::DIVRANK) && (I->_type != Ifelm::KBDRANK))
+                        continue;
+                  int d = (I->_action0 >> 16) & 255;
+                  int r = (I->_action0 >>  8) & 255;
+                  Rank* R = _divis [d]._ranks + r;
+                  if (R->_count == _count)
+                        continue;
+                  R->_count = _count;
+                  jobs.append({ d, r, R->_sdef, new Rankwave (R->_sdef->_n0, R->_sdef->_n1) });
+                  }
+            }
+
+      float  fsamp = _aeolus->_fsamp;
+      float  fbase = _fbase;
+      float* scale = scales [_itemp]._data;
+      const char* path = _waves;
+      QtConcurrent::blockingMap(jobs, [fsamp, fbase, scale, path](RankJob& job) {
+            if (job.wave->load (path, job.sdef, fsamp, fbase, scale))
+                  job.wave->gen_waves (job.sdef, fsamp, fbase, scale, (job.d << 8) | job.r);
+            });
+
+      for (const RankJob& job : jobs) {
+            _aeolus->_divisp [job.d]->set_rank (job.r, job.wave, job.sdef->_pan, job.sdef->_del);
+            _divis [job.d]._ranks [job.r]._wave = job.wave;
             }
       _ready = true;
       }
@@ -202,7 +250,7 @@ void Model::proc_rank (int g, int i, int comm)
 
                   M._wave = new Rankwave (M._sdef->_n0, M._sdef->_n1);
                   if (M._wave->load (M._path, M._sdef, M._fsamp, M._fbase, M._scale))
-                        M._wave->gen_waves (M._sdef, M._fsamp, M._fbase, M._scale);
+                        M._wave->gen_waves (M._sdef, M._fsamp, M._fbase, M._scale, (M._divis << 8) | M._rank);
 
                   _aeolus->_divisp [M._divis]->set_rank (M._rank, M._wave,  M._sdef->_pan, M._sdef->_del);
                   _divis [M._divis]._ranks [M._rank]._wave = M._wave;
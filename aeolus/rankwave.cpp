@@ -16,7 +16,9 @@
     Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 */
 
+#include <time.h>
 #include "rankwave.h"
+#include "blockops.h"
 
 #define DEBUG
 
@@ -24,21 +26,11 @@ extern float exp2ap (float);
 
 
 Rngen   Pipewave::_rgen;
-float  *Pipewave::_arg = 0;
-float  *Pipewave::_att = 0;
-
-void Pipewave::initstatic(float fsamp)
-      {
-      if (_arg)
-            return;
-      int k = (int)(fsamp);
-      _arg  = new float [k];
-      k     = (int)(0.5f * fsamp);
-      _att  = new float [k];
-      }
 
 //---------------------------------------------------------
 //   play
+//    the attack is mixed a block at a time, contiguous
+//    runs of the interpolated loop (_k_s == 1) too
 //---------------------------------------------------------
 
 void Pipewave::play()
@@ -80,11 +72,9 @@ void Pipewave::play()
 
         if (r < _p1)
         {
-            while (k1--)
-            {
-	        *q++ += g * *r++;
-                g -= dg;
-            }
+            AeolusBlock::addRamp (q, r, PERIOD, g, dg);
+            r += PERIOD;
+            g -= PERIOD * dg;
         }
         else
 	{
@@ -108,6 +98,15 @@ void Pipewave::play()
                 k1 -= k2;
                 if (k2<0)
                   k2 = 0;
+                if (_k_s == 1)
+                {
+                    AeolusBlock::addInterp (q, r, k2, y, dy, g, dg);
+                    q += k2;
+                    r += k2;
+                    y += k2 * dy;
+                    g -= k2 * dg;
+                    k2 = 0;
+                }
                 while (k2--)
        	        {
                     *q++ += g * (r [0] + y * (r [1] - r [0]));
@@ -136,10 +135,8 @@ void Pipewave::play()
         q = _out;
         if (p < _p1)
         {
-            while (k1--)
-            {
-		*q++ += *p++;
-	    }
+            AeolusBlock::add (q, p, PERIOD);
+            p += PERIOD;
         }
         else
 	{
@@ -164,6 +161,14 @@ void Pipewave::play()
                 k1 -= k2;
                 if (k2<0)
                   k2 = 0;
+                if (_k_s == 1)
+                {
+                    AeolusBlock::addInterp (q, p, k2, y, dy, 1.0f, 0.0f);
+                    q += k2;
+                    p += k2;
+                    y += k2 * dy;
+                    k2 = 0;
+                }
                 while (k2--)
        	        {
                     *q++ += p [0] + y * (p [1] - p [0]);
@@ -183,7 +188,13 @@ void Pipewave::play()
 }
 
 
-void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
+//---------------------------------------------------------
+//   genwave
+//    rgen, arg and att belong to the caller, so pipes of
+//    different ranks can be generated concurrently
+//---------------------------------------------------------
+
+void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe, Rngen& rgen, float* arg, float* att)
 {
     int    h, i, k, nc;
     float  f0, f1, f, m, t, v, v0;
@@ -197,7 +208,7 @@ void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
     _l0 = (int)(fsamp * m + 0.5);
     _l0 = (_l0 + PERIOD - 1) & ~(PERIOD - 1);
 
-    f1 = (fpipe + D->_n_off.vi (n) + D->_n_ran.vi (n) * (2 * _rgen.urand () - 1)) / fsamp;
+    f1 = (fpipe + D->_n_off.vi (n) + D->_n_ran.vi (n) * (2 * rgen.urand () - 1)) / fsamp;
     f0 = f1 * exp2ap (D->_n_atd.vi (n) / 1200.0f);
 
     for (h = N_HARM - 1; h >= 0; h--)
@@ -234,14 +245,14 @@ void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
     k = (int)(fsamp * D->_n_att.vi (n) + 0.5);
     for (i = 0; i <= _l0; i++)
     {
-        _arg [i] = t - floorf (t + 0.5);
+        arg [i] = t - floorf (t + 0.5);
 	t += (i < k) ? (((k - i) * f0 + i * f1) / k) : f1;
     }
 
     for (i = 1; i < _l1; i++)
     {
-	t = _arg [_l0]+ (float) i * nc / _l1;
-        _arg [i + _l0] = t - floorf (t + 0.5);
+	t = arg [_l0]+ (float) i * nc / _l1;
+        arg [i + _l0] = t - floorf (t + 0.5);
     }
 
     v0 = exp2ap (0.1661 * D->_n_vol.vi (n));
@@ -251,16 +262,16 @@ void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
         v = D->_h_lev.vi (h, n);
         if (v < -80.0) continue;
 
-        v = v0 * exp2ap (0.1661 * (v + D->_h_ran.vi (h, n) * (2 * _rgen.urand () - 1)));
+        v = v0 * exp2ap (0.1661 * (v + D->_h_ran.vi (h, n) * (2 * rgen.urand () - 1)));
         k = (int)(fsamp * D->_h_att.vi (h, n) + 0.5);
-        attgain (k, D->_h_atp.vi (h, n));
+        attgain (k, D->_h_atp.vi (h, n), att);
 
         for (i = 0; i < _l0 + _l1; i++)
         {
-	    t = _arg [i] * (h + 1);
+	    t = arg [i] * (h + 1);
             t -= floorf (t);
             m = v * sinf (2 * M_PI * t);
-            if (i < k) m *= _att [i];
+            if (i < k) m *= att [i];
             _p0 [i] += m;
         }
     }
@@ -311,7 +322,7 @@ void Pipewave::looplen (float f, float fsamp, int lmax, int *aa, int *bb)
 }
 
 
-void Pipewave::attgain (int n, float p)
+void Pipewave::attgain (int n, float p, float* att)
 {
     int    i, j, k;
     float  d, m, w, x, y, z;
@@ -331,7 +342,7 @@ void Pipewave::attgain (int n, float p)
         while (j < k)
 	{
             m = (double) j / n;
-            _att [j++] = (1.0 - m) * z + m;
+            att [j++] = (1.0 - m) * z + m;
             z += d;
 	}
     }
@@ -402,14 +413,27 @@ Rankwave::~Rankwave (void)
 }
 
 
-void Rankwave::gen_waves (Addsynth *D, float fsamp, float fbase, float *scale)
+//---------------------------------------------------------
+//   gen_waves
+//    safe to call for different ranks concurrently
+//    rank - (division << 8) | rank index, identifies the
+//           rank for its random sequence
+//---------------------------------------------------------
+
+void Rankwave::gen_waves (Addsynth *D, float fsamp, float fbase, float *scale, int rank)
 {
-    Pipewave::initstatic (fsamp);
+    std::vector<float> arg ((int)(fsamp));
+    std::vector<float> att ((int)(0.5f * fsamp));
+
+    // own random sequence per rank, different ranks must not detune alike,
+    // even if they share a stop definition
+    Rngen rgen;
+    rgen.init ((uint32_t (time (0)) ^ (D->checksum () | 1) ^ (uint32_t (rank + 1) * 0x9e3779b9u)) | 1);
 
     fbase *=  D->_fn / (D->_fd * scale [9]);
     for (int i = _n0; i <= _n1; i++)
     {
-	_pipes [i - _n0].genwave (D, i - _n0, fsamp, ldexpf (fbase * scale [i % 12], i / 12 - 5));
+	_pipes [i - _n0].genwave (D, i - _n0, fsamp, ldexpf (fbase * scale [i % 12], i / 12 - 5), rgen, arg.data (), att.data ());
     }
     _modif = true;
 }
@@ -472,14 +496,11 @@ int Rankwave::save (const char *path, Addsynth *D, float fsamp, float fbase, flo
 
     memset (data, 0, 16);
     strcpy (data, "ae1");
-    data [4] = 1;
+    data [4] = 2;
     fwrite (data, 1, 16, F);
 
     memset (data, 0, 64);
-    data [0] = 0;
-    data [1] = 0;
-    data [2] = 0;
-    data [3] = 0;
+    *((uint32_t *)(data +  0)) = D->checksum ();
     data [4] = _n0;
     data [5] = _n1;
     data [6] = 0;
@@ -531,7 +552,7 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
         return 1;
     }
 
-    if (data [4] != 1)
+    if (data [4] != 2)
     {
 #ifdef DEBUG
 	fprintf (stderr, "File '%s' has an incompatible version tag (%d)\n", name, data [4]);
@@ -550,6 +571,15 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
         return 1;
     }
 
+    if (*((uint32_t *)(data + 0)) != D->checksum ())
+    {
+#ifdef DEBUG
+	fprintf (stderr, "File '%s' was generated from a different stop definition\n", name);
+#endif
+        fclose (F);
+        return 1;
+    }
+
     f = *((float *)(data + 8));
     if (fabsf (f - fsamp) > 0.1f)
     {
@@ -42,13 +42,13 @@ private:
 
     friend class Rankwave;
 
-    void genwave (Addsynth *D, int n, float fsamp, float fpipe);
+    void genwave (Addsynth *D, int n, float fsamp, float fpipe, Rngen& rgen, float* arg, float* att);
     void save (FILE *F);
     void load (FILE *F);
     void play (void);
 
     static void looplen (float f, float fsamp, int lmax, int *aa, int *bb);
-    static void attgain (int n, float p);
+    static void attgain (int n, float p, float* att);
 
     float     *_p0;    // attack start
     float     *_p1;    // loop start
@@ -74,11 +74,7 @@ private:
     int16_t    _i_r;   // release count
 
 
-    static void initstatic (float fsamp);
-
-    static   Rngen   _rgen;
-    static   float  *_arg;
-    static   float  *_att;
+    static   Rngen   _rgen;    // used by play() on the audio thread only
 };
 
 //---------------------------------------------------------
@@ -134,7 +130,7 @@ public:
     int  n1 (void) const { return _n1; }
     void play (int shift);
     void set_param (float *out, int del, int pan);
-    void gen_waves (Addsynth *D, float fsamp, float fbase, float *scale);
+    void gen_waves (Addsynth *D, float fsamp, float fbase, float *scale, int rank);
     int  save (const char *path, Addsynth *D, float fsamp, float fbase, float *scale);
     int  load (const char *path, Addsynth *D, float fsamp, float fbase, float *scale);
     bool modif (void) const { return _modif; }
@@ -19,8 +19,32 @@
 #include <math.h>
 #include "zita.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ZITA_SSE
+#endif
+
 namespace Ms {
 
+//---------------------------------------------------------
+//   FlushDenormals
+//    set flush to zero and denormals are zero while the
+//    reverb runs, restore the caller's mode afterwards
+//---------------------------------------------------------
+
+class FlushDenormals
+      {
+#ifdef ZITA_SSE
+      unsigned _csr;
+#endif
+
+   public:
+#ifdef ZITA_SSE
+      FlushDenormals()  { _csr = _mm_getcsr(); _mm_setcsr(_csr | 0x8040); }
+      ~FlushDenormals() { _mm_setcsr(_csr); }
+#endif
+      };
+
 enum {
       R_DELAY, R_XOVER, R_RTLOW, R_RTMID, R_FDAMP,
       R_EQ1FR, R_EQ1GN,
@@ -233,6 +257,41 @@ void Diff1::fini()
       _line = 0;
       }
 
+//---------------------------------------------------------
+//   process
+//    allpass n frames of x in place; n must not exceed the
+//    line length
+//---------------------------------------------------------
+
+void Diff1::process(float* x, int n)
+      {
+      while (n) {
+            int k = qMin(n, _size - _i);
+            float* line = _line + _i;
+            int j = 0;
+#ifdef ZITA_SSE
+            __m128 c = _mm_set1_ps(_c);
+            for (; j + 4 <= k; j += 4) {
+                  __m128 z = _mm_loadu_ps(line + j);
+                  __m128 y = _mm_sub_ps(_mm_loadu_ps(x + j), _mm_mul_ps(c, z));
+                  _mm_storeu_ps(line + j, y);
+                  _mm_storeu_ps(x + j, _mm_add_ps(z, _mm_mul_ps(c, y)));
+                  }
+#endif
+            for (; j < k; ++j) {
+                  float z = line[j];
+                  float y = x[j] - _c * z;
+                  line[j] = y;
+                  x[j]    = z + _c * y;
+                  }
+            _i += k;
+            if (_i == _size)
+                  _i = 0;
+            x += k;
+            n -= k;
+            }
+      }
+
 Delay::Delay()
    : _size (0), _line (0)
       {
@@ -258,6 +317,32 @@ void Delay::fini ()
       _line = 0;
       }
 
+//---------------------------------------------------------
+//   read
+//    the next n frames, without advancing
+//---------------------------------------------------------
+
+void Delay::read (float* x, int n) const
+      {
+      int k = qMin(n, _size - _i);
+      memcpy(x, _line + _i, k * sizeof(float));
+      memcpy(x + k, _line, (n - k) * sizeof(float));
+      }
+
+//---------------------------------------------------------
+//   write
+//---------------------------------------------------------
+
+void Delay::write (const float* x, int n)
+      {
+      int k = qMin(n, _size - _i);
+      memcpy(_line + _i, x, k * sizeof(float));
+      memcpy(_line, x + k, (n - k) * sizeof(float));
+      _i += n;
+      if (_i >= _size)
+            _i -= _size;
+      }
+
 Vdelay::Vdelay ()
    : _size (0), _line (0)
       {
@@ -291,14 +376,116 @@ void Vdelay::set_delay (int del)
             _ir += _size;
       }
 
-void Filt1::set_params (float del, float tmf, float tlo, float wlo, float thi, float chi)
+//---------------------------------------------------------
+//   read
+//---------------------------------------------------------
+
+void Vdelay::read (float* x, int n)
       {
-      _gmf = powf (0.001f, del / tmf);
-      _glo = powf (0.001f, del / tlo) / _gmf - 1.0f;
-      _wlo = wlo;
-      float g    = powf (0.001f, del / thi) / _gmf;
-      float t    = (1 - g * g) / (2 * g * g * chi);
-      _whi = (sqrtf (1 + 4 * t) - 1) / (2 * t);
+      int k = qMin(n, _size - _ir);
+      memcpy(x, _line + _ir, k * sizeof(float));
+      memcpy(x + k, _line, (n - k) * sizeof(float));
+      _ir += n;
+      if (_ir >= _size)
+            _ir -= _size;
+      }
+
+//---------------------------------------------------------
+//   write
+//---------------------------------------------------------
+
+void Vdelay::write (const float* x, int n)
+      {
+      int k = qMin(n, _size - _iw);
+      memcpy(_line + _iw, x, k * sizeof(float));
+      memcpy(_line, x + k, (n - k) * sizeof(float));
+      _iw += n;
+      if (_iw >= _size)
+            _iw -= _size;
+      }
+
+//---------------------------------------------------------
+//   Filt8
+//---------------------------------------------------------
+
+Filt8::Filt8()
+      {
+      for (int c = 0; c < 8; ++c) {
+            _gmf[c] = _glo[c] = _wlo[c] = _whi[c] = 0.0f;
+            _slo[c] = _shi[c] = 0.0f;
+            }
+      }
+
+//---------------------------------------------------------
+//   set_params
+//---------------------------------------------------------
+
+void Filt8::set_params (int c, float del, float tmf, float tlo, float wlo, float thi, float chi)
+      {
+      _gmf[c] = powf (0.001f, del / tmf);
+      _glo[c] = powf (0.001f, del / tlo) / _gmf[c] - 1.0f;
+      _wlo[c] = wlo;
+      float g = powf (0.001f, del / thi) / _gmf[c];
+      float t = (1 - g * g) / (2 * g * g * chi);
+      _whi[c] = (sqrtf (1 + 4 * t) - 1) / (2 * t);
+      }
+
+//---------------------------------------------------------
+//   process
+//    filter g * x[c][j] in place for the eight rows of x;
+//    the vector path transposes four frames of four rows
+//    so that one register holds one frame of four channels
+//---------------------------------------------------------
+
+void Filt8::process(int n, float* const* x, float g)
+      {
+      int j = 0;
+#ifdef ZITA_SSE
+      const __m128 gv  = _mm_set1_ps(g);
+      const __m128 eps = _mm_set1_ps(1e-10f);
+      for (int h = 0; h < 8; h += 4) {
+            const __m128 gmf = _mm_loadu_ps(_gmf + h);
+            const __m128 glo = _mm_loadu_ps(_glo + h);
+            const __m128 wlo = _mm_loadu_ps(_wlo + h);
+            const __m128 whi = _mm_loadu_ps(_whi + h);
+            __m128 slo = _mm_loadu_ps(_slo + h);
+            __m128 shi = _mm_loadu_ps(_shi + h);
+            auto step = [&](__m128 v) {
+                  v   = _mm_mul_ps(gv, v);
+                  slo = _mm_add_ps(slo, _mm_add_ps(_mm_mul_ps(wlo, _mm_sub_ps(v, slo)), eps));
+                  v   = _mm_add_ps(v, _mm_mul_ps(glo, slo));
+                  shi = _mm_add_ps(shi, _mm_mul_ps(whi, _mm_sub_ps(v, shi)));
+                  return _mm_mul_ps(gmf, shi);
+                  };
+            for (j = 0; j + 4 <= n; j += 4) {
+                  __m128 r0 = _mm_loadu_ps(x[h] + j);
+                  __m128 r1 = _mm_loadu_ps(x[h + 1] + j);
+                  __m128 r2 = _mm_loadu_ps(x[h + 2] + j);
+                  __m128 r3 = _mm_loadu_ps(x[h + 3] + j);
+                  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                  r0 = step(r0);
+                  r1 = step(r1);
+                  r2 = step(r2);
+                  r3 = step(r3);
+                  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                  _mm_storeu_ps(x[h] + j, r0);
+                  _mm_storeu_ps(x[h + 1] + j, r1);
+                  _mm_storeu_ps(x[h + 2] + j, r2);
+                  _mm_storeu_ps(x[h + 3] + j, r3);
+                  }
+            _mm_storeu_ps(_slo + h, slo);
+            _mm_storeu_ps(_shi + h, shi);
+            }
+#endif
+      for (; j < n; ++j) {
+            for (int c = 0; c < 8; ++c) {
+                  float v = g * x[c][j];
+                  _slo[c] += _wlo[c] * (v - _slo[c]) + 1e-10f;
+                  v += _glo[c] * _slo[c];
+                  _shi[c] += _whi[c] * (v - _shi[c]);
+                  x[c][j] = _gmf[c] * _shi[c];
+                  }
+            }
       }
 
 float ZitaReverb::_tdiff1 [8] = {
@@ -350,12 +537,19 @@ void ZitaReverb::init(float fsamp)
 
       _vdelay0.init ((int)(0.1f * _fsamp));
       _vdelay1.init ((int)(0.1f * _fsamp));
+      // a block must not wrap around any line: the delays are
+      // read before they are written, and the input delay must
+      // not overwrite frames it has still to read
+      int maxdel = (int)(floorf ((0.100f - 0.020f) * _fsamp + 0.5f));
+      _block = qMin(int(BLOCK), _vdelay0._size - maxdel);
       for (int i = 0; i < 8; i++) {
             int k1 = (int)(floorf (_tdiff1 [i] * _fsamp + 0.5f));
             int k2 = (int)(floorf (_tdelay [i] * _fsamp + 0.5f));
             _diff1 [i].init (k1, (i & 1) ? -0.6f : 0.6f);
             _delay [i].init (k2 - k1);
+            _block = qMin(_block, qMin(k1, k2 - k1));
             }
+      _block = qMax(_block, 1);
 
       _pareq1.setfsamp(fsamp);
       _pareq2.setfsamp(fsamp);
@@ -400,7 +594,7 @@ void ZitaReverb::prepare (int nfram)
             else
                   chi = 1 - cosf (6.2832f * _fdamp / _fsamp);
             for (int i = 0; i < 8; i++) {
-                  _filt1 [i].set_params (_tdelay [i], _rtmid, _rtlow, wlo, 0.5f * _rtmid, chi);
+                  _filt1.set_params (i, _tdelay [i], _rtmid, _rtlow, wlo, 0.5f * _rtmid, chi);
                   }
             _cntB2 = b;
             }
@@ -417,15 +611,92 @@ void ZitaReverb::prepare (int nfram)
       _pareq2.prepare (nfram);
       }
 
+//---------------------------------------------------------
+//   processBlock
+//    run n <= _block frames through the feedback delay
+//    network, writing the wet signal to out
+//---------------------------------------------------------
+
+void ZitaReverb::processBlock(int n, const float* inp, float* out)
+      {
+      const float g = sqrtf (0.125f);
+      float* x[8];
+      for (int c = 0; c < 8; c++)
+            x[c] = _x[c];
+
+      for (int j = 0; j < n; j++) {
+            _t0[j] = inp[2 * j];
+            _t1[j] = inp[2 * j + 1];
+            }
+      _vdelay0.write (_t0, n);
+      _vdelay1.write (_t1, n);
+      _vdelay0.read (_t0, n);
+      _vdelay1.read (_t1, n);
+      for (int j = 0; j < n; j++) {
+            _t0[j] *= 0.3f;
+            _t1[j] *= 0.3f;
+            }
+
+      for (int c = 0; c < 8; c++) {
+            const float* t = c < 4 ? _t0 : _t1;
+            float* p = x[c];
+            _delay[c].read (p, n);
+            if (c & 2) {
+                  for (int j = 0; j < n; j++)
+                        p[j] -= t[j];
+                  }
+            else {
+                  for (int j = 0; j < n; j++)
+                        p[j] += t[j];
+                  }
+            _diff1[c].process (p, n);
+            }
+
+      // eight point Hadamard transform, frame by frame
+      static const int pairs[12][2] = {
+            { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+            { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+            { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
+            };
+      for (const auto& pr : pairs) {
+            float* a = x[pr[0]];
+            float* b = x[pr[1]];
+            int j = 0;
+#ifdef ZITA_SSE
+            for (; j + 4 <= n; j += 4) {
+                  __m128 va = _mm_loadu_ps(a + j);
+                  __m128 vb = _mm_loadu_ps(b + j);
+                  _mm_storeu_ps(a + j, _mm_add_ps(va, vb));
+                  _mm_storeu_ps(b + j, _mm_sub_ps(va, vb));
+                  }
+#endif
+            for (; j < n; j++) {
+                  float t = a[j] - b[j];
+                  a[j] += b[j];
+                  b[j] = t;
+                  }
+            }
+
+      const float* x1 = x[1];
+      const float* x2 = x[2];
+      for (int j = 0; j < n; j++) {
+            _g1 += _d1;
+            out[2 * j]     = _g1 * (x1[j] + x2[j]);
+            out[2 * j + 1] = _g1 * (x1[j] - x2[j]);
+            }
+
+      _filt1.process (n, x, g);
+      for (int c = 0; c < 8; c++)
+            _delay[c].write (x[c], n);
+      }
+
 //---------------------------------------------------------
 //   process
 //---------------------------------------------------------
 
 void ZitaReverb::process (int nfram, float* inp, float* out)
       {
-      float t, g, x0, x1, x2, x3, x4, x5, x6, x7;
-      g = sqrtf (0.125f);
-
+      FlushDenormals fd;
 
       while (nfram) {
             if (!_nsamp) {
@@ -433,55 +704,9 @@ void ZitaReverb::process (int nfram, float* inp, float* out)
                   _nsamp = _fragm;
                   }
 
-            int k = _nsamp < nfram ? _nsamp : nfram;
-
-            float* p0 = inp;
-            float* p1 = inp + 1;
-            float* q0 = out;
-            float* q1 = out + 1;
-
-            for (int i = 0; i < k * 2; i += 2) {
-                  _vdelay0.write (p0 [i]);
-                  _vdelay1.write (p1 [i]);
-
-                  t = 0.3f * _vdelay0.read ();
-                  x0 = _diff1 [0].process (_delay [0].read () + t);
-                  x1 = _diff1 [1].process (_delay [1].read () + t);
-                  x2 = _diff1 [2].process (_delay [2].read () - t);
-                  x3 = _diff1 [3].process (_delay [3].read () - t);
-                  t = 0.3f * _vdelay1.read ();
-                  x4 = _diff1 [4].process (_delay [4].read () + t);
-                  x5 = _diff1 [5].process (_delay [5].read () + t);
-                  x6 = _diff1 [6].process (_delay [6].read () - t);
-                  x7 = _diff1 [7].process (_delay [7].read () - t);
-
-                  t = x0 - x1; x0 += x1;  x1 = t;
-                  t = x2 - x3; x2 += x3;  x3 = t;
-                  t = x4 - x5; x4 += x5;  x5 = t;
-                  t = x6 - x7; x6 += x7;  x7 = t;
-                  t = x0 - x2; x0 += x2;  x2 = t;
-                  t = x1 - x3; x1 += x3;  x3 = t;
-                  t = x4 - x6; x4 += x6;  x6 = t;
-                  t = x5 - x7; x5 += x7;  x7 = t;
-                  t = x0 - x4; x0 += x4;  x4 = t;
-                  t = x1 - x5; x1 += x5;  x5 = t;
-                  t = x2 - x6; x2 += x6;  x6 = t;
-                  t = x3 - x7; x3 += x7;  x7 = t;
-
-                  _g1 += _d1;
-
-                  q0 [i] = _g1 * (x1 + x2);
-                  q1 [i] = _g1 * (x1 - x2);
-
-                  _delay [0].write (_filt1 [0].process (g * x0));
-                  _delay [1].write (_filt1 [1].process (g * x1));
-                  _delay [2].write (_filt1 [2].process (g * x2));
-                  _delay [3].write (_filt1 [3].process (g * x3));
-                  _delay [4].write (_filt1 [4].process (g * x4));
-                  _delay [5].write (_filt1 [5].process (g * x5));
-                  _delay [6].write (_filt1 [6].process (g * x6));
-                  _delay [7].write (_filt1 [7].process (g * x7));
-                  }
+            int k = qMin(qMin(_nsamp, nfram), _block);
+
+            processBlock (k, inp, out);
             _pareq1.process (k, out);
             _pareq2.process (k, out);
 
@@ -97,41 +97,31 @@ class Diff1
       void  init(int size, float c);
       void  fini();
 
-      float process(float x) {
-            float z = _line [_i];
-            x -= _c * z;
-            _line [_i] = x;
-            if (++_i == _size)
-                  _i = 0;
-            return z + _c * x;
-            }
+      void  process(float* x, int n);
       };
 
 //---------------------------------------------------------
-//   Filt1
+//   Filt8
+//    the feedback filters of the eight delay lines; the
+//    state is kept per parameter so that one block runs
+//    through all channels at once
 //---------------------------------------------------------
 
-class Filt1
+class Filt8
       {
       friend class ZitaReverb;
 
-      Filt1 () : _slo (0), _shi (0) {}
-      ~Filt1 () {}
+      Filt8();
 
-      void  set_params (float del, float tmf, float tlo, float wlo, float thi, float chi);
+      void  set_params (int c, float del, float tmf, float tlo, float wlo, float thi, float chi);
+      void  process(int n, float* const* x, float g);
 
-      float process(float x) {
-            _slo += _wlo * (x - _slo) + 1e-10f;
-            x += _glo * _slo;
-            _shi += _whi * (x - _shi);
-            return _gmf * _shi;
-            }
-      float   _gmf;
-      float   _glo;
-      float   _wlo;
-      float   _whi;
-      float   _slo;
-      float   _shi;
+      float   _gmf[8];
+      float   _glo[8];
+      float   _wlo[8];
+      float   _whi[8];
+      float   _slo[8];
+      float   _shi[8];
       };
 
 //---------------------------------------------------------
@@ -148,13 +138,9 @@ class Delay
       void  init (int size);
       void  fini ();
 
-      float read () { return _line [_i]; }
+      void  read (float* x, int n) const;
+      void  write (const float* x, int n);
 
-      void write (float x) {
-            _line [_i++] = x;
-            if (_i == _size)
-                  _i = 0;
-            }
       int     _i;
       int     _size;
       float  *_line;
@@ -175,18 +161,9 @@ class Vdelay
       void  fini ();
       void  set_delay (int del);
 
-      float read () {
-            float x = _line [_ir++];
-            if (_ir == _size)
-                  _ir = 0;
-            return x;
-            }
+      void  read (float* x, int n);
+      void  write (const float* x, int n);
 
-      void write (float x) {
-            _line [_iw++] = x;
-            if (_iw == _size)
-                  _iw = 0;
-            }
       int     _ir;
       int     _iw;
       int     _size;
@@ -206,9 +183,15 @@ class ZitaReverb : public Effect
       Vdelay  _vdelay0;
       Vdelay  _vdelay1;
       Diff1   _diff1[8];
-      Filt1   _filt1[8];
+      Filt8   _filt1;
       Delay   _delay[8];
 
+      enum { BLOCK = 128 };
+      int     _block;               // frames per block, <= BLOCK
+      float   _t0[BLOCK];
+      float   _t1[BLOCK];
+      float   _x[8][BLOCK];         // one row per delay line
+
       volatile int _cntA1;
       volatile int _cntB1;
       volatile int _cntC1;
@@ -237,6 +220,7 @@ class ZitaReverb : public Effect
       int _nsamp;
 
       void prepare(int n);
+      void processBlock(int n, const float* inp, float* out);
 
    public:
       ZitaReverb() : Effect() {}
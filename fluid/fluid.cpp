@@ -20,6 +20,7 @@
 
 #include "synthesizer/event.h"
 #include "synthesizer/msynthesizer.h"
+#include "synthesizer/renderpool.h"
 #include "mscore/preferences.h"
 #include "mscore/extension.h"
 
@@ -96,11 +97,42 @@ void Fluid::init(float sampleRate)
       for (int i = 0; i < 128; ++i)
             _tuning[i] = i * 100.0;
       _masterTuning = 440.0;
+      initFilterTable();
 
       for (int i = 0; i < 512; i++)
             freeVoices.append(new Voice(this));
       }
 
+//---------------------------------------------------------
+//   initFilterTable
+//    sine and cosine of the filter cutoff for every cent
+//    from 5 Hz up to 0.45 times the sample rate; cutoff
+//    values outside are clamped to that range
+//---------------------------------------------------------
+
+void Fluid::initFilterTable()
+      {
+      const double lo = 5.0;
+      const double hi = 0.45 * sample_rate;
+      int n = int(1200.0 * log2(hi / lo)) + 1;
+      _filterTable.resize(n + 1);
+      for (int i = 0; i <= n; ++i) {
+            double omega = 2.0 * M_PI * qMin(lo * pow(2.0, i / 1200.0), hi) / sample_rate;
+            _filterTable[i] = { float(sin(omega)), float(cos(omega)) };
+            }
+      setMasterTuning(_masterTuning);
+      }
+
+//---------------------------------------------------------
+//   setMasterTuning
+//---------------------------------------------------------
+
+void Fluid::setMasterTuning(double f)
+      {
+      _masterTuning      = f;
+      _filterCentsOffset = float(1200.0 * log2(f / 5.0) - 6900.0);
+      }
+
 //---------------------------------------------------------
 //   ~Fluid
 //---------------------------------------------------------
@@ -123,6 +155,8 @@ Fluid::~Fluid()
 
 void Fluid::freeVoice(Voice* v)
       {
+      if (_deferFreeVoices)
+            return;
       if (activeVoices.removeOne(v))
             freeVoices.append(v);
       }
@@ -394,17 +428,69 @@ void Fluid::update_presets()
             c->setPreset(get_preset(c->getSfontnum(), c->getBanknum(), c->getPrognum()));
       }
 
+//---------------------------------------------------------
+//   renderVoices
+//    voices finishing during the block cannot leave
+//    activeVoices while it is iterated, here or on a
+//    worker thread; free them when all are done
+//---------------------------------------------------------
+
+void Fluid::renderVoices(unsigned len, float* out, float* effect1, float* effect2)
+      {
+      const QList<Voice*>& voices = activeVoices;
+      _deferFreeVoices = true;
+      bool parallel = _renderPool && _renderPool->render(voices, len, out, effect1, effect2,
+         [](Voice* v, unsigned n, float* o, float* e1, float* e2) { v->write(n, o, e1, e2); });
+      if (!parallel) {
+            for (Voice* v : voices)
+                  v->write(len, out, effect1, effect2);
+            }
+      _deferFreeVoices = false;
+
+      int n = 0;
+      for (int i = 0; i < activeVoices.size(); ++i) {
+            Voice* v = activeVoices[i];
+            if (v->status == FLUID_VOICE_OFF)
+                  freeVoices.append(v);
+            else
+                  activeVoices[n++] = v;
+            }
+      while (activeVoices.size() > n)
+            activeVoices.removeLast();
+      }
+
 //---------------------------------------------------------
 //   process
+//    the block is silent while the soundfonts are changed
 //---------------------------------------------------------
 
 void Fluid::process(unsigned len, float* out, float* effect1, float* effect2)
       {
       if (mutex.tryLock()) {
-            //we have to copy voices array for proper output sound processing in for loop
-            auto tempVoices = activeVoices;
-            for (Voice* v : tempVoices)
-                  v->write(len, out, effect1, effect2);
+            renderVoices(len, out, effect1, effect2);
+            mutex.unlock();
+            }
+      }
+
+//---------------------------------------------------------
+//   processEvents
+//    split the block at the events, taking the lock once
+//---------------------------------------------------------
+
+void Fluid::processEvents(unsigned len, float* out, float* effect1, float* effect2, const std::vector<TimedEvent>& events)
+      {
+      const bool locked = mutex.tryLock();
+      unsigned pos = 0;
+      for (const TimedEvent& e : events) {
+            unsigned frame = qMin(e.frame, len);
+            if (locked && frame > pos)
+                  renderVoices(frame - pos, out + pos * 2, effect1 + pos * 2, effect2 + pos * 2);
+            pos = frame;
+            play(e.event);
+            }
+      if (locked) {
+            if (len > pos)
+                  renderVoices(len - pos, out + pos * 2, effect1 + pos * 2, effect2 + pos * 2);
             mutex.unlock();
             }
       }
@@ -300,12 +300,20 @@ class Fluid : public Synthesizer {
 
       QList<Voice*> freeVoices;           // unused synthesis processes
       QList<Voice*> activeVoices;         // active synthesis processes
+      bool _deferFreeVoices = false;      // voices are being rendered, see renderVoices()
       QString _error;                     // last error message
 
       static bool initialized;
 
       double sample_rate;                 // The sample rate
       float _masterTuning;                // usually 440.0
+
+      struct FilterCoeff {
+            float sin;
+            float cos;
+            };
+      std::vector<FilterCoeff> _filterTable;    // per cent of filter cutoff, see initFilterTable()
+      float _filterCentsOffset;           // filter cutoff in cents to index into _filterTable
       double _tuning[128];                // the pitch of every key, in cents
 
       int _loadProgress = 0;
@@ -313,6 +321,8 @@ class Fluid : public Synthesizer {
 
       QMutex mutex;
       void updatePatchList();
+      void initFilterTable();
+      void renderVoices(unsigned len, float* out, float* effect1, float* effect2);
 
       //the variable is used to stop loading samples from the sf files
       bool _globalTerminate = false;
@@ -390,6 +400,7 @@ class Fluid : public Synthesizer {
       void free_voice_by_kill();
 
       virtual void process(unsigned len, float* out, float* effect1, float* effect2);
+      virtual void processEvents(unsigned len, float* out, float* effect1, float* effect2, const std::vector<TimedEvent>&);
 
       bool program_select(int chan, unsigned sfont_id, unsigned bank_num, unsigned preset_num);
       void get_program(int chan, unsigned* sfont_id, unsigned* bank_num, unsigned* preset_num);
@@ -409,7 +420,12 @@ class Fluid : public Synthesizer {
       float ct2hz(float cents)       { return act2hz(qBound(1500.0f, cents, 13500.0f)); }
 
       virtual double masterTuning() const     { return _masterTuning; }
-      virtual void setMasterTuning(double f)  { _masterTuning = f;    }
+      virtual void setMasterTuning(double f);
+
+      int filterIndex(float cents) const {
+            return qBound(0, int(lrintf(cents + _filterCentsOffset)), int(_filterTable.size()) - 1);
+            }
+      const FilterCoeff& filterCoeff(int idx) const { return _filterTable[idx]; }
 
       QString error() const { return _error; }
 
@@ -140,6 +140,7 @@ void Voice::init(Sample* _sample, Channel* _channel, int _key, int _vel,
       vel            = _vel;
       channel        = _channel;
       mod_count      = 0;
+      _modulatedGens = 0;
       sample         = _sample;
       ticks          = 0;
       debug          = 0;
@@ -515,8 +516,9 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
             
             /*************** resonant filter ******************/
             
-            /* calculate the frequency of the resonant filter in Hz */
-            float _fres = _fluid->ct2hz_real(fres
+            /* look up the frequency of the resonant filter, quantized to
+             * cents, in the filter table of the synthesizer */
+            int fresIdx = _fluid->filterIndex(fres
                                        + modlfo_val * modlfo_to_fc
                                        + modenv_val * modenv_to_fc);
             
@@ -531,15 +533,12 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
              * synthesizer was run at lower sampling rates. Thanks to Stephan
              * Tassart for pointing me to this bug. By turning the filter on and
              * clipping the maximum filter frequency at 0.45*srate, the filter
-             * is used as an anti-aliasing filter. */
+             * is used as an anti-aliasing filter. The filter table covers
+             * 5 Hz to 0.45 times the sampling rate, filterIndex() clamps
+             * to that range. */
             
-            if (_fres > 0.45f * _fluid->sample_rate)
-                  _fres = 0.45f * _fluid->sample_rate;
-            else if (_fres < 5)
-                  _fres = 5;
-            
-            /* if filter enabled and there is a significant frequency change.. */
-            if ((qAbs(_fres - last_fres) > 0.01)) {
+            /* if filter enabled and the frequency changed by a cent or more.. */
+            if (fresIdx != last_fres) {
                   /* The filter coefficients have to be recalculated (filter
                    * parameters have changed). Recalculation for various reasons is
                    * forced by setting last_fres to -1.  The flag filter_startup
@@ -555,9 +554,8 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                    * into account for both significant frequency relocation and for
                    * bandwidth readjustment'. */
                   
-                  float omega = (float) (2.0 * M_PI * (_fres / ((float) _fluid->sample_rate)));
-                  float sin_coeff = (float) sin(omega);
-                  float cos_coeff = (float) cos(omega);
+                  float sin_coeff = _fluid->filterCoeff(fresIdx).sin;
+                  float cos_coeff = _fluid->filterCoeff(fresIdx).cos;
                   float alpha_coeff = sin_coeff / (2.0f * q_lin);
                   float a0_inv = 1.0f / (1.0f + alpha_coeff);
                   
@@ -607,7 +605,7 @@ bool Voice::generateDataForDSPChain(unsigned framesBufCount)
                         /* Have to add the increments filter_coeff_incr_count times. */
                         filter_coeff_incr_count = FILTER_TRANSITION_SAMPLES;
                         }
-                  last_fres = _fres;
+                  last_fres = fresIdx;
                   fluid_check_fpe ("voice_write filter calculation");
                   }
             
@@ -648,6 +646,8 @@ void Voice::write(unsigned n, float* out, float* reverb, float* chorus)
             off();
             return;
             }
+      if (_modulatedGens.load(std::memory_order_relaxed))
+            updateModulatedGens();
             
       /*
        /  ------- CACHING ALGORITHM -------
@@ -1002,7 +1002,7 @@ void Voice::update_param(int _gen)
 
                   /* The synthesis loop will have to recalculate the filter
                    * coefficients. */
-                  last_fres = -1.0f;
+                  last_fres = -1;
                   break;
 
             case GEN_FILTERQ:
@@ -1051,7 +1051,7 @@ void Voice::update_param(int _gen)
                   filter_gain = (float) (1.0 / sqrt(q_lin));
 
                   /* The synthesis loop will have to recalculate the filter coefficients. */
-                  last_fres = -1.;
+                  last_fres = -1;
                   break;
 
             case GEN_MODLFOTOPITCH:
@@ -1355,6 +1355,10 @@ void Voice::update_param(int _gen)
  *
  * - For every changed generator, convert its value to the correct
  * unit of the corresponding DSP parameter
+ *
+ * Only the first step is done here; the changed generators are
+ * collected until the next write(), which does the other two steps
+ * once per generator in updateModulatedGens().
  * */
 
 void Voice::modulate(bool _cc, int _ctrl)
@@ -1368,33 +1372,15 @@ void Voice::modulate(bool _cc, int _ctrl)
             (_ctrl == BREATH_MSB || _ctrl == FOOT_MSB || _ctrl == EXPRESSION_MSB))
             return;
 
+      // Only remember which generators are affected, write() updates
+      // them once per block however many controller changes came in.
+      quint64 gens = 0;
       for (int i = 0; i < mod_count; i++) {
-            Mod* m = &mod[i];
-
-            /* step 1: find all the modulators that have the changed controller
-             * as input source.
-             */
-            if (m->has_source(_cc, _ctrl)) {
-                  int g = m->get_dest();
-                  float modval = 0.0;
-
-                  /* step 2: for every changed modulator, calculate the modulation
-                   * value of its associated generator
-                   */
-                  for (int k = 0; k < mod_count; k++) {
-                        if (fluid_mod_has_dest(&mod[k], g)) {
-                              modval += mod[k].get_value(channel, this);
-                              }
-                        }
-                  gen[g].set_mod(modval);
-
-                  /* step 3: now that we have the new value of the generator,
-                   * recalculate the parameter values that are derived from the
-                   * generator
-                   */
-                  update_param(g);
-                  }
+            if (mod[i].has_source(_cc, _ctrl))
+                  gens |= quint64(1) << mod[i].get_dest();
             }
+      if (gens)
+            _modulatedGens.fetch_or(gens);
       }
 
 /**
@@ -1406,32 +1392,33 @@ void Voice::modulate(bool _cc, int _ctrl)
  */
 void Voice::modulate_all()
       {
-      /* Loop through all the modulators.
-        FIXME: we should loop through the set of generators instead of
-        the set of modulators. We risk to call 'fluid_voice_update_param'
-        several times for the same generator if several modulators have
-        that generator as destination. It's not an error, just a wast of
-        energy (think pollution, global warming, unhappy musicians, ...)
-       */
+      quint64 gens = 0;
+      for (int i = 0; i < mod_count; i++)
+            gens |= quint64(1) << mod[i].get_dest();
+      if (gens)
+            _modulatedGens.fetch_or(gens);
+      }
 
-      for (int i = 0; i < mod_count; i++) {
-            Mod* m       = &mod[i];
-            int g        = m->get_dest();
-            float modval = 0.0;
+//---------------------------------------------------------
+//   updateModulatedGens
+//    Recalculate the modulation of every generator marked
+//    by modulate() and the parameters derived from it.
+//    Every generator is handled once, even if several
+//    modulators or controller changes affect it.
+//---------------------------------------------------------
 
-            /* Accumulate the modulation values of all the modulators with
-             * destination generator 'gen'
-             */
+void Voice::updateModulatedGens()
+      {
+      quint64 gens = _modulatedGens.exchange(0);
+      for (int g = 0; gens; ++g, gens >>= 1) {
+            if (!(gens & 1))
+                  continue;
+            float modval = 0.0;
             for (int k = 0; k < mod_count; k++) {
                   if (fluid_mod_has_dest(&mod[k], g))
                         modval += mod[k].get_value(channel, this);
                   }
-
             gen[g].set_mod(modval);
-
-            /* Update the parameter values that are depend on the generator
-             * 'gen'
-             */
             update_param(g);
             }
       }
@@ -1871,16 +1858,18 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
 
       /* Two versions of the filter loop. One, while the filter is
        * changing towards its new setting. The other, if the filter
-       * doesn't change.
+       * doesn't change. The filter runs in place on dsp_buf, panning
+       * and the effect sends are mixed in a separate pass, which has
+       * no dependencies between samples and vectorizes.
        */
 
+      float* buf = dsp_buf.data() + startBufIdx;
       if (filter_coeff_incr_count > 0) {
             /* Increment is added to each filter coefficient filter_coeff_incr_count times. */
-            for (int i = startBufIdx; i < startBufIdx + count; i++) {
+            for (int i = 0; i < count; i++) {
                   /* The filter is implemented in Direct-II form. */
-                  auto& dspValRef = dsp_buf[i];
-                  float dsp_centernode = dspValRef - a1 * hist1 - a2 * hist2;
-                  dspValRef = b02 * (dsp_centernode + hist2) + b1 * hist1;
+                  float dsp_centernode = buf[i] - a1 * hist1 - a2 * hist2;
+                  buf[i] = b02 * (dsp_centernode + hist2) + b1 * hist1;
                   hist2 = hist1;
                   hist1 = dsp_centernode;
 
@@ -1890,37 +1879,42 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
                         b02 += b02_incr;
                         b1  += b1_incr;
                         }
-
-                  //code duplication is needed to optimize using std::vector::operator[]
-                  float vv = dspValRef * amp_left;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
-
-                  vv = dspValRef * amp_right;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
                   }
             }
       else { /* The filter parameters are constant.  This is duplicated to save time. */
-            for (int i = startBufIdx; i < startBufIdx + count; i++) {   // The filter is implemented in Direct-II form.
-                  auto& dspValRef = dsp_buf[i];
-                  float dsp_centernode = dspValRef - a1 * hist1 - a2 * hist2;
-                  dspValRef      = b02 * (dsp_centernode + hist2) + b1 * hist1;
-                  hist2          = hist1;
-                  hist1          = dsp_centernode;
-
-                  //code duplication is needed to optimize using std::vector::operator[]
-                  float vv = dspValRef * amp_left;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
-
-                  vv = dspValRef * amp_right;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
+            float h1 = hist1;
+            float h2 = hist2;
+            for (int i = 0; i < count; i++) {   // The filter is implemented in Direct-II form.
+                  float dsp_centernode = buf[i] - a1 * h1 - a2 * h2;
+                  buf[i] = b02 * (dsp_centernode + h2) + b1 * h1;
+                  h2     = h1;
+                  h1     = dsp_centernode;
+                  }
+            hist1 = h1;
+            hist2 = h2;
+            }
+
+      const float left  = amp_left;
+      const float right = amp_right;
+      for (int i = 0; i < count; i++) {
+            out[2 * i]     += buf[i] * left;
+            out[2 * i + 1] += buf[i] * right;
+            }
+      /* sends are often off, skip them then */
+      if (amp_reverb != 0.0f) {
+            const float l = left * amp_reverb;
+            const float r = right * amp_reverb;
+            for (int i = 0; i < count; i++) {
+                  reverb[2 * i]     += buf[i] * l;
+                  reverb[2 * i + 1] += buf[i] * r;
+                  }
+            }
+      if (amp_chorus != 0.0f) {
+            const float l = left * amp_chorus;
+            const float r = right * amp_chorus;
+            for (int i = 0; i < count; i++) {
+                  chorus[2 * i]     += buf[i] * l;
+                  chorus[2 * i + 1] += buf[i] * r;
                   }
             }
       }
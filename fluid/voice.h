@@ -21,11 +21,14 @@
 #ifndef _FLUID_VOICE_H
 #define _FLUID_VOICE_H
 
+#include <atomic>
 #include "fluid.h"
 #include "gen.h"
 
 namespace FluidS {
 
+static_assert(GEN_LAST <= 64, "Voice::_modulatedGens holds one bit per generator");
+
 #define NO_CHANNEL             0xff
 
 enum fluid_voice_status {
@@ -110,6 +113,7 @@ public:
 	Channel* channel;
 	Generator gen[GEN_LAST];
 	Mod mod[FLUID_NUM_MOD];
+	std::atomic<quint64> _modulatedGens { 0 };   /* bit set of generators to update in write(), see modulate() */
 
 	int mod_count;
 	bool has_looped;                /* Flag that is set as soon as the first loop is completed. */
@@ -174,9 +178,9 @@ public:
 
 	/* resonant filter */
 	float fres;              /* the resonance frequency, in cents (not absolute cents) */
-	float last_fres;         /* Current resonance frequency of the IIR filter */
-	/* Serves as a flag: A deviation between fres and last_fres */
-	/* indicates, that the filter has to be recalculated. */
+	int last_fres;           /* Filter table index of the current resonance frequency */
+	/* Serves as a flag: A deviation between the index of fres and */
+	/* last_fres indicates, that the filter has to be recalculated. */
 	float q_lin;             /* the q-factor on a linear scale */
 	float filter_gain;       /* Gain correction factor, depends on q */
 	float hist1, hist2;      /* Sample history for the IIR filter */
@@ -241,6 +245,7 @@ public:
 
       void modulate_all();
       void modulate(bool _cc, int _ctrl);
+      void updateModulatedGens();
       float get_lower_boundary_for_attenuation();
       void check_sample_sanity();
       void noteoff();
@@ -666,392 +666,415 @@ struct Bm {
       signed char s;     // beam slant in 1/4 spatium units
       Bm() : l(0), s(0) {}
       Bm(signed char a, signed char b) : l(a), s(b) {}
-      static int key(int a, int b, int c) { return ((a & 0xff) << 16) | ((b & 0xff) << 8) | (c & 0xff); }
       };
 
-static QHash<int, Bm> bMetrics;
-
 //---------------------------------------------------------
-//   initBeamMetrics
+//   beamMetrics
+//    constant table, safe to use from any thread
 //---------------------------------------------------------
 
-#define B(a,b,c,d,e) bMetrics[Bm::key(a, b, c)] = Bm(d, e);
-
-static void initBeamMetrics()
-      {
+static const struct {
+      signed char up;
+      signed char l1;
+      signed char l2;
+      signed char l;
+      signed char s;
+      } beamMetrics[] = {
       // up  step1 step2 stemLen1 slant
       //                 (- up)   (- up)
       // =================================== C
-      B(1,  10, 10, -12,  0);
-      B(0,   3,  3,  11,  0);
-      B(1,   3,  3, -11,  0);
-
-      B(1,  10,  9, -12, -1);
-      B(1,  10,  8, -12, -4);
-      B(1,  10,  7, -12, -5);
-      B(1,  10,  6, -15, -5);
-      B(1,  10,  5, -16, -5);
-      B(1,  10,  4, -20, -4);
-      B(1,  10,  3, -20, -5);
-
-      B(1,  10,  11, -12, 1);
-      B(1,  10,  12, -13, 2);      // F
-      B(1,  10,  13, -13, 2);
-      B(1,  10,  14, -13, 2);
-      B(1,  10,  15, -13, 2);
-
-      B(1,  3,  4, -11, 1);
-      B(1,  3,  5, -11, 2);
-      B(1,  3,  6, -11, 4);
-      B(1,  3,  7, -11, 5);
-      B(1,  3,  8, -11, 5);
-      B(1,  3,  9, -11, 5);
-      B(1,  3, 10, -11, 5);
-
-      B(0, -4, -3,  15, 1);
-      B(0, -4, -2,  15, 2);
-      B(0, -4, -1,  15, 2);
-      B(0, -4,  0,  15, 5);
-      B(0, -4,  1,  16, 5);
-      B(0, -4,  2,  20, 4);
-      B(0, -4,  3,  20, 5);
-
-      B(0,  3,  4,  13, 1);
-      B(0,  3,  5,  13, 2);
-      B(0,  3,  6,  14, 4);
-      B(0,  3,  7,  14, 4);
-      B(0,  3,  8,  14, 6);
-
-      B(0,  3,  2,  11, -1);
-      B(0,  3,  1,  11, -2);
-      B(0,  3,  0,  11, -5);
-      B(0,  3, -1,  11, -5);
-      B(0,  3, -2,  11, -5);
-      B(0,  3, -3,  11, -5);
-      B(0,  3, -4,  11, -5);
+      {  1,  10,  10,  -12,   0 },
+      {  0,   3,   3,   11,   0 },
+      {  1,   3,   3,  -11,   0 },
+
+      {  1,  10,   9,  -12,  -1 },
+      {  1,  10,   8,  -12,  -4 },
+      {  1,  10,   7,  -12,  -5 },
+      {  1,  10,   6,  -15,  -5 },
+      {  1,  10,   5,  -16,  -5 },
+      {  1,  10,   4,  -20,  -4 },
+      {  1,  10,   3,  -20,  -5 },
+
+      {  1,  10,  11,  -12,   1 },
+      {  1,  10,  12,  -13,   2 },      // F
+      {  1,  10,  13,  -13,   2 },
+      {  1,  10,  14,  -13,   2 },
+      {  1,  10,  15,  -13,   2 },
+
+      {  1,   3,   4,  -11,   1 },
+      {  1,   3,   5,  -11,   2 },
+      {  1,   3,   6,  -11,   4 },
+      {  1,   3,   7,  -11,   5 },
+      {  1,   3,   8,  -11,   5 },
+      {  1,   3,   9,  -11,   5 },
+      {  1,   3,  10,  -11,   5 },
+
+      {  0,  -4,  -3,   15,   1 },
+      {  0,  -4,  -2,   15,   2 },
+      {  0,  -4,  -1,   15,   2 },
+      {  0,  -4,   0,   15,   5 },
+      {  0,  -4,   1,   16,   5 },
+      {  0,  -4,   2,   20,   4 },
+      {  0,  -4,   3,   20,   5 },
+
+      {  0,   3,   4,   13,   1 },
+      {  0,   3,   5,   13,   2 },
+      {  0,   3,   6,   14,   4 },
+      {  0,   3,   7,   14,   4 },
+      {  0,   3,   8,   14,   6 },
+
+      {  0,   3,   2,   11,  -1 },
+      {  0,   3,   1,   11,  -2 },
+      {  0,   3,   0,   11,  -5 },
+      {  0,   3,  -1,   11,  -5 },
+      {  0,   3,  -2,   11,  -5 },
+      {  0,   3,  -3,   11,  -5 },
+      {  0,   3,  -4,   11,  -5 },
 
       // =================================== D
-      B(1,  9,  9,  -13, 0);
-      B(0,  2,  2,   12, 0);
-      B(1,  2,  2,  -11, 0);
-
-      B(1,  9,  8,  -13, -1);
-      B(1,  9,  7,  -13, -2);
-      B(1,  9,  6,  -13, -5);
-      B(1,  9,  5,  -14, -5);
-      B(1,  9,  4,  -16, -6);
-      B(1,  9,  3,  -17, -5);
-      B(1,  9,  2,  -17, -8);
-
-      B(1,  9, 10,  -11, 1);
-      B(1,  9, 11,  -11, 2);
-      B(1,  9, 12,  -11, 2);
-      B(1,  9, 13,  -11, 2);
-      B(1,  9, 14,  -11, 2);
-      B(1,  9, 15,  -11, 2);
-
-      B(1,  2, 3,   -12, 1);
-      B(1,  2, 4,   -12, 2);
-      B(1,  2, 5,   -12, 4);
-      B(1,  2, 6,   -12, 5);
-      B(1,  2, 7,   -11, 5);
-      B(1,  2, 8,   -12, 5);
-      B(1,  2, 9,   -12, 8);
-
-      B(0, -5,-4,   16, 2);
-      B(0, -5,-3,   16, 2);
-      B(0, -5,-2,   17, 2);
-      B(0, -5,-1,   17, 2);
-      B(0, -5, 0,   18, 4);
-      B(0, -5, 1,   18, 5);
-      B(0, -5, 2,   21, 5);
-
-      B(0,  2, 3,   12, 1);
-      B(0,  2, 4,   12, 4);
-      B(0,  2, 5,   13, 4);  // F
-      B(0,  2, 6,   15, 5);
-      B(0,  2, 7,   15, 6);
-      B(0,  2, 8,   16, 8);
-      B(0,  2, 9,   16, 8);
-
-      B(0,  2,  1,   12, -1);
-      B(0,  2,  0,   12, -4);
-      B(0,  2, -1,   12, -5);
-      B(0,  2, -2,   12, -5);
-      B(0,  2, -3,   12, -4);
-      B(0,  2, -4,   12, -4);
-      B(0,  2, -5,   12, -5);
+      {  1,   9,   9,  -13,   0 },
+      {  0,   2,   2,   12,   0 },
+      {  1,   2,   2,  -11,   0 },
+
+      {  1,   9,   8,  -13,  -1 },
+      {  1,   9,   7,  -13,  -2 },
+      {  1,   9,   6,  -13,  -5 },
+      {  1,   9,   5,  -14,  -5 },
+      {  1,   9,   4,  -16,  -6 },
+      {  1,   9,   3,  -17,  -5 },
+      {  1,   9,   2,  -17,  -8 },
+
+      {  1,   9,  10,  -11,   1 },
+      {  1,   9,  11,  -11,   2 },
+      {  1,   9,  12,  -11,   2 },
+      {  1,   9,  13,  -11,   2 },
+      {  1,   9,  14,  -11,   2 },
+      {  1,   9,  15,  -11,   2 },
+
+      {  1,   2,   3,  -12,   1 },
+      {  1,   2,   4,  -12,   2 },
+      {  1,   2,   5,  -12,   4 },
+      {  1,   2,   6,  -12,   5 },
+      {  1,   2,   7,  -11,   5 },
+      {  1,   2,   8,  -12,   5 },
+      {  1,   2,   9,  -12,   8 },
+
+      {  0,  -5,  -4,   16,   2 },
+      {  0,  -5,  -3,   16,   2 },
+      {  0,  -5,  -2,   17,   2 },
+      {  0,  -5,  -1,   17,   2 },
+      {  0,  -5,   0,   18,   4 },
+      {  0,  -5,   1,   18,   5 },
+      {  0,  -5,   2,   21,   5 },
+
+      {  0,   2,   3,   12,   1 },
+      {  0,   2,   4,   12,   4 },
+      {  0,   2,   5,   13,   4 },  // F
+      {  0,   2,   6,   15,   5 },
+      {  0,   2,   7,   15,   6 },
+      {  0,   2,   8,   16,   8 },
+      {  0,   2,   9,   16,   8 },
+
+      {  0,   2,   1,   12,  -1 },
+      {  0,   2,   0,   12,  -4 },
+      {  0,   2,  -1,   12,  -5 },
+      {  0,   2,  -2,   12,  -5 },
+      {  0,   2,  -3,   12,  -4 },
+      {  0,   2,  -4,   12,  -4 },
+      {  0,   2,  -5,   12,  -5 },
 
       // =================================== E
-      B(1, 8, 8,  -12, 0);
-      B(0, 1, 1,   13, 0);
-      B(1, 1, 1,  -12, 0);
-
-      B(1, 8, 7, -12, -1);
-      B(1, 8, 6, -12, -4);
-      B(1, 8, 5, -12, -5);
-      B(1, 8, 4, -15, -5);
-      B(1, 8, 3, -16, -5);
-      B(1, 8, 2, -17, -6);
-      B(1, 8, 1, -19, -6);
-
-      B(1, 15, 11, -21, -1);
-      B(1, 15, 10, -21, -1);
-      B(1, 15,  9, -21, -4);
-      B(1, 15,  8, -21, -5);
-
-      B(1,  1,  8, -11,  6);
-      B(1,  1,  7, -11,  6);
-      B(1,  1,  6, -12,  6);
-
-      B(1,  8,  9, -12,  1);
-      B(1,  8, 10, -12,  4);
-      B(1,  8, 11, -12,  5);
-      B(1,  8, 12, -12,  5);
-      B(1,  8, 13, -12,  4);
-      B(1,  8, 14, -12,  5);
-      B(1,  8, 15, -12,  5);
-
-      B(0,  1,  0, 11,  -1);
-      B(0,  1, -1, 11,  -2);
-      B(0,  1, -2, 11,  -5);
-      B(0,  1, -3, 11,  -5);
-      B(0,  1, -4, 11,  -5);
-      B(0,  1, -5, 11,  -5);
-      B(0,  1, -6, 11,  -5);
-
-      B(0, 1, 2, 13, 1);
-      B(0, 1, 3, 13, 2);
-      B(0, 1, 4, 13, 5);
-      B(0, 1, 5, 14, 5);
-      B(0, 1, 6, 15, 5);
-      B(0, 1, 7, 17, 5);
-      B(0, 1, 8, 17, 8);
-
-      B(0, -6, -2,  19, 2);
-      B(0, -6, -1,  19, 4);
-      B(0, -6,  0,  20, 4);
-      B(0, -6,  1,  20, 5);
-
-      B(0, 8, 3, 9,  -6);
-      B(0, 8, 2, 12, -8);
-      B(0, 8, 1, 12, -8);
+      {  1,   8,   8,  -12,   0 },
+      {  0,   1,   1,   13,   0 },
+      {  1,   1,   1,  -12,   0 },
+
+      {  1,   8,   7,  -12,  -1 },
+      {  1,   8,   6,  -12,  -4 },
+      {  1,   8,   5,  -12,  -5 },
+      {  1,   8,   4,  -15,  -5 },
+      {  1,   8,   3,  -16,  -5 },
+      {  1,   8,   2,  -17,  -6 },
+      {  1,   8,   1,  -19,  -6 },
+
+      {  1,  15,  11,  -21,  -1 },
+      {  1,  15,  10,  -21,  -1 },
+      {  1,  15,   9,  -21,  -4 },
+      {  1,  15,   8,  -21,  -5 },
+
+      {  1,   1,   8,  -11,   6 },
+      {  1,   1,   7,  -11,   6 },
+      {  1,   1,   6,  -12,   6 },
+
+      {  1,   8,   9,  -12,   1 },
+      {  1,   8,  10,  -12,   4 },
+      {  1,   8,  11,  -12,   5 },
+      {  1,   8,  12,  -12,   5 },
+      {  1,   8,  13,  -12,   4 },
+      {  1,   8,  14,  -12,   5 },
+      {  1,   8,  15,  -12,   5 },
+
+      {  0,   1,   0,   11,  -1 },
+      {  0,   1,  -1,   11,  -2 },
+      {  0,   1,  -2,   11,  -5 },
+      {  0,   1,  -3,   11,  -5 },
+      {  0,   1,  -4,   11,  -5 },
+      {  0,   1,  -5,   11,  -5 },
+      {  0,   1,  -6,   11,  -5 },
+
+      {  0,   1,   2,   13,   1 },
+      {  0,   1,   3,   13,   2 },
+      {  0,   1,   4,   13,   5 },
+      {  0,   1,   5,   14,   5 },
+      {  0,   1,   6,   15,   5 },
+      {  0,   1,   7,   17,   5 },
+      {  0,   1,   8,   17,   8 },
+
+      {  0,  -6,  -2,   19,   2 },
+      {  0,  -6,  -1,   19,   4 },
+      {  0,  -6,   0,   20,   4 },
+      {  0,  -6,   1,   20,   5 },
+
+      {  0,   8,   3,    9,  -6 },
+      {  0,   8,   2,   12,  -8 },
+      {  0,   8,   1,   12,  -8 },
 
       // =================================== F
-      B(1, 7, 7,-13, 0);      //F
-      B(0, 0, 0, 12, 0);
-      B(0, 7, 7, 12, 0);
-
-      B(1, 7, 6, -13, -1);
-      B(1, 7, 5, -13, -2);
-      B(1, 7, 4, -13, -5);
-      B(1, 7, 3, -14, -5);
-      B(1, 7, 2, -15, -6);
-      B(1, 7, 1, -17, -6);
-      B(1, 7, 0, -18, -8);
-
-      B(1, 14, 10, -19, -2);
-      B(1, 14,  9, -19, -2);
-      B(1, 14,  8, -20, -4);
-      B(1, 14,  7, -20, -5);
-
-      B(1,  0,  5,  -9, 6);
-      B(1,  0,  6, -12, 8);
-      B(1,  0,  7, -12, 8);
-
-      B(1, 7,  8, -11, 1);
-      B(1, 7,  9, -11, 2);
-      B(1, 7, 10, -11, 5);
-      B(1, 7, 11, -11, 5);
-      B(1, 7, 12, -11, 5);
-      B(1, 7, 13, -11, 5);
-      B(1, 7, 14, -11, 5);
-
-      B(0, 0, -1, 12, -1);
-      B(0, 0, -2, 12, -4);
-      B(0, 0, -3, 12, -5);
-      B(0, 0, -4, 12, -5);
-      B(0, 0, -5, 12, -4);
-      B(0, 0, -6, 12, -4);
-      B(0, 0, -7, 12, -4);
-
-      B(0, 0, 1, 12, 1);
-      B(0, 0, 2, 12, 4);
-      B(0, 0, 3, 12, 5);
-      B(0, 0, 4, 15, 5);
-      B(0, 0, 5, 16, 5);
-      B(0, 0, 6, 17, 5);
-      B(0, 0, 7, 19, 6);
-
-      B(0, -7, -3, 21, 2);
-      B(0, -7, -2, 21, 2);
-      B(0, -7, -1, 21, 2);
-      B(0, -7,  0, 22, 4);
-
-      B(0, 7, 2, 12, -6);
-      B(0, 7, 1, 11, -6);
-      B(0, 7, 0, 11, -6);
+      {  1,   7,   7,  -13,   0 },      //F
+      {  0,   0,   0,   12,   0 },
+      {  0,   7,   7,   12,   0 },
+
+      {  1,   7,   6,  -13,  -1 },
+      {  1,   7,   5,  -13,  -2 },
+      {  1,   7,   4,  -13,  -5 },
+      {  1,   7,   3,  -14,  -5 },
+      {  1,   7,   2,  -15,  -6 },
+      {  1,   7,   1,  -17,  -6 },
+      {  1,   7,   0,  -18,  -8 },
+
+      {  1,  14,  10,  -19,  -2 },
+      {  1,  14,   9,  -19,  -2 },
+      {  1,  14,   8,  -20,  -4 },
+      {  1,  14,   7,  -20,  -5 },
+
+      {  1,   0,   5,   -9,   6 },
+      {  1,   0,   6,  -12,   8 },
+      {  1,   0,   7,  -12,   8 },
+
+      {  1,   7,   8,  -11,   1 },
+      {  1,   7,   9,  -11,   2 },
+      {  1,   7,  10,  -11,   5 },
+      {  1,   7,  11,  -11,   5 },
+      {  1,   7,  12,  -11,   5 },
+      {  1,   7,  13,  -11,   5 },
+      {  1,   7,  14,  -11,   5 },
+
+      {  0,   0,  -1,   12,  -1 },
+      {  0,   0,  -2,   12,  -4 },
+      {  0,   0,  -3,   12,  -5 },
+      {  0,   0,  -4,   12,  -5 },
+      {  0,   0,  -5,   12,  -4 },
+      {  0,   0,  -6,   12,  -4 },
+      {  0,   0,  -7,   12,  -4 },
+
+      {  0,   0,   1,   12,   1 },
+      {  0,   0,   2,   12,   4 },
+      {  0,   0,   3,   12,   5 },
+      {  0,   0,   4,   15,   5 },
+      {  0,   0,   5,   16,   5 },
+      {  0,   0,   6,   17,   5 },
+      {  0,   0,   7,   19,   6 },
+
+      {  0,  -7,  -3,   21,   2 },
+      {  0,  -7,  -2,   21,   2 },
+      {  0,  -7,  -1,   21,   2 },
+      {  0,  -7,   0,   22,   4 },
+
+      {  0,   7,   2,   12,  -6 },
+      {  0,   7,   1,   11,  -6 },
+      {  0,   7,   0,   11,  -6 },
 
       // =================================== G
-      B(1,  6,  6, -12, 0);
-      B(0, -1, -1,  13, 0);
-      B(0,  6,  6,  11, 0);
-
-      B(1, 6,  5, -12, -1);
-      B(1, 6,  4, -12, -4);
-      B(1, 6,  3, -13, -4);
-      B(1, 6,  2, -15, -5);
-      B(1, 6,  1, -13, -7);
-      B(1, 6,  0, -16, -8);
-      B(1, 6, -1, -16, -8);
-
-      B(1, 13, 10, -17, -2);
-      B(1, 13,  9, -17, -2);
-      B(1, 13,  8, -18, -4);
-      B(1, 13,  7, -18, -5);
-      B(1, 13,  6, -21, -5);
-
-      B(1, -1, 6, -10, 8);
-
-      B(1, 6,  7, -12, 1);
-      B(1, 6,  8, -12, 4);
-      B(1, 6,  9, -12, 5);
-      B(1, 6, 10, -12, 5);
-      B(1, 6, 11, -12, 4);
-      B(1, 6, 12, -12, 5);
-      B(1, 6, 13, -12, 5);
-
-      B(0, -1, -2, 11, -1);
-      B(0, -1, -3, 11, -2);
-      B(0, -1, -4, 11, -2);
-      B(0, -1, -5, 11, -2);
-      B(0, -1, -6, 11, -2);
-      B(0, -1, -7, 11, -2);
-
-      B(0, -1,  0, 13, 1);
-      B(0, -1,  1, 13, 2);
-      B(0, -1,  2, 13, 5);
-      B(0, -1,  3, 14, 5);
-      B(0, -1,  4, 17, 6);
-      B(0, -1,  5, 18, 5);
-      B(0, -1,  6, 18, 8);
-
-      B(0,  6,  5, 12, -4);
-      B(0,  6,  4, 12, -4);
-      B(0,  6,  3, 12, -4);
-      B(0,  6,  2, 12, -6);
-      B(0,  6,  1, 11, -6);
-      B(0,  6,  0, 12, -7);
-      B(0,  6, -1, 12, -8);
+      {  1,   6,   6,  -12,   0 },
+      {  0,  -1,  -1,   13,   0 },
+      {  0,   6,   6,   11,   0 },
+
+      {  1,   6,   5,  -12,  -1 },
+      {  1,   6,   4,  -12,  -4 },
+      {  1,   6,   3,  -13,  -4 },
+      {  1,   6,   2,  -15,  -5 },
+      {  1,   6,   1,  -13,  -7 },
+      {  1,   6,   0,  -16,  -8 },
+      {  1,   6,  -1,  -16,  -8 },
+
+      {  1,  13,  10,  -17,  -2 },
+      {  1,  13,   9,  -17,  -2 },
+      {  1,  13,   8,  -18,  -4 },
+      {  1,  13,   7,  -18,  -5 },
+      {  1,  13,   6,  -21,  -5 },
+
+      {  1,  -1,   6,  -10,   8 },
+
+      {  1,   6,   7,  -12,   1 },
+      {  1,   6,   8,  -12,   4 },
+      {  1,   6,   9,  -12,   5 },
+      {  1,   6,  10,  -12,   5 },
+      {  1,   6,  11,  -12,   4 },
+      {  1,   6,  12,  -12,   5 },
+      {  1,   6,  13,  -12,   5 },
+
+      {  0,  -1,  -2,   11,  -1 },
+      {  0,  -1,  -3,   11,  -2 },
+      {  0,  -1,  -4,   11,  -2 },
+      {  0,  -1,  -5,   11,  -2 },
+      {  0,  -1,  -6,   11,  -2 },
+      {  0,  -1,  -7,   11,  -2 },
+
+      {  0,  -1,   0,   13,   1 },
+      {  0,  -1,   1,   13,   2 },
+      {  0,  -1,   2,   13,   5 },
+      {  0,  -1,   3,   14,   5 },
+      {  0,  -1,   4,   17,   6 },
+      {  0,  -1,   5,   18,   5 },
+      {  0,  -1,   6,   18,   8 },
+
+      {  0,   6,   5,   12,  -4 },
+      {  0,   6,   4,   12,  -4 },
+      {  0,   6,   3,   12,  -4 },
+      {  0,   6,   2,   12,  -6 },
+      {  0,   6,   1,   11,  -6 },
+      {  0,   6,   0,   12,  -7 },
+      {  0,   6,  -1,   12,  -8 },
 
       // =================================== A
-      B(1,  5,  5, -11, 0);
-      B(0, -2, -2,  12, 0);
-      B(0,  5,  5,  11, 0);
-
-      B(1,  5,  4, -13, -1);
-      B(1,  5,  3, -13, -2);
-      B(1,  5,  2, -14, -4);
-      B(1,  5,  1, -15, -4);
-      B(1,  5,  0, -15, -6);
-
-      B(1, 12, 11, -15, -1);
-      B(1, 12, 10, -15, -2);
-      B(1, 12,  9, -15, -2);
-      B(1, 12,  8, -15, -5);
-      B(1, 12,  7, -16, -5);
-      B(1, 12,  6, -20, -4);
-      B(1, 12,  5, -20, -5);
-
-      B(1,  5,  6, -11,  1);
-      B(1,  5,  7, -11,  2);
-      B(1,  5,  8, -11,  5);
-      B(1,  5,  9, -11,  5);
-      B(1,  5, 10, -11,  5);
-      B(1,  5, 11, -11,  5);
-      B(1,  5, 12, -11,  5);
-
-      B(0, -2, -1, 12, 1);
-      B(0, -2,  0, 12, 4);
-      B(0, -2,  1, 12, 5);
-      B(0, -2,  2, 15, 5);
-      B(0, -2,  3, 16, 5);
-      B(0, -2,  4, 20, 4);
-      B(0, -2,  5, 20, 5);
-
-      B(0, -2, -3, 12, -1);
-      B(0, -2, -4, 13, -2);
-      B(0, -2, -5, 13, -2);
-      B(0, -2, -6, 13, -2);
-      B(0, -2, -7, 13, -2);
-
-      B(0,  5,  4, 11, -1);
-      B(0,  5,  3, 11, -2);
-      B(0,  5,  2, 11, -4);
-      B(0,  5,  1, 11, -5);
-      B(0,  5,  0, 11, -5);
-      B(0,  5, -1, 11, -5);
-      B(0,  5, -2, 11, -5);
+      {  1,   5,   5,  -11,   0 },
+      {  0,  -2,  -2,   12,   0 },
+      {  0,   5,   5,   11,   0 },
+
+      {  1,   5,   4,  -13,  -1 },
+      {  1,   5,   3,  -13,  -2 },
+      {  1,   5,   2,  -14,  -4 },
+      {  1,   5,   1,  -15,  -4 },
+      {  1,   5,   0,  -15,  -6 },
+
+      {  1,  12,  11,  -15,  -1 },
+      {  1,  12,  10,  -15,  -2 },
+      {  1,  12,   9,  -15,  -2 },
+      {  1,  12,   8,  -15,  -5 },
+      {  1,  12,   7,  -16,  -5 },
+      {  1,  12,   6,  -20,  -4 },
+      {  1,  12,   5,  -20,  -5 },
+
+      {  1,   5,   6,  -11,   1 },
+      {  1,   5,   7,  -11,   2 },
+      {  1,   5,   8,  -11,   5 },
+      {  1,   5,   9,  -11,   5 },
+      {  1,   5,  10,  -11,   5 },
+      {  1,   5,  11,  -11,   5 },
+      {  1,   5,  12,  -11,   5 },
+
+      {  0,  -2,  -1,   12,   1 },
+      {  0,  -2,   0,   12,   4 },
+      {  0,  -2,   1,   12,   5 },
+      {  0,  -2,   2,   15,   5 },
+      {  0,  -2,   3,   16,   5 },
+      {  0,  -2,   4,   20,   4 },
+      {  0,  -2,   5,   20,   5 },
+
+      {  0,  -2,  -3,   12,  -1 },
+      {  0,  -2,  -4,   13,  -2 },
+      {  0,  -2,  -5,   13,  -2 },
+      {  0,  -2,  -6,   13,  -2 },
+      {  0,  -2,  -7,   13,  -2 },
+
+      {  0,   5,   4,   11,  -1 },
+      {  0,   5,   3,   11,  -2 },
+      {  0,   5,   2,   11,  -4 },
+      {  0,   5,   1,   11,  -5 },
+      {  0,   5,   0,   11,  -5 },
+      {  0,   5,  -1,   11,  -5 },
+      {  0,   5,  -2,   11,  -5 },
 
       // =================================== B
-      B(1,  4,  4, -12, 0);
-      B(1, 11, 11, -13, 0);
-      B(0,  4,  4,  12, 0);
-      B(0, -3, -3,  13, 0);
-
-      B(1, 11, 10, -13, -1);
-      B(1, 11,  9, -13, -2);
-      B(1, 11,  8, -13, -5);
-      B(1, 11,  7, -14, -5);
-      B(1, 11,  6, -18, -4);
-      B(1, 11,  5, -18, -5);
-      B(1, 11,  4, -21, -5);
-
-      B(1,  4,  3, -12, -1);
-      B(1,  4,  2, -12, -4);
-      B(1,  4,  1, -14, -4);
-      B(1,  4,  0, -16, -4);
-
-      B(1, 11, 12, -14, 1);
-      B(1, 11, 13, -14, 1);
-      B(1, 11, 14, -14, 1);
-      B(1, 11, 15, -15, 2);
-      B(1, 11, 16, -15, 2);
-
-      B(1,  4,  5, -12, 1);
-      B(1,  4,  6, -12, 4);
-      B(1,  4,  7, -12, 5);
-      B(1,  4,  8, -12, 5);
-      B(1,  4,  9, -13, 6);
-      B(1,  4, 10, -12, 4);
-      B(1,  4, 11, -12, 5);
-
-      B(0,  4,  3, 12, -1);
-      B(0,  4,  2, 12, -4);
-      B(0,  4,  1, 12, -5);
-      B(0,  4,  0, 12, -5);
-      B(0,  4, -1, 13, -6);
-      B(0,  4, -2, 12, -4);
-      B(0,  4, -3, 12, -5);
-
-      B(0,  4,  5, 12, 1);
-      B(0,  4,  6, 12, 4);
-
-      B(0, -3, -4, 14, -1);
-      B(0, -3, -5, 14, -1);
-      B(0, -3, -6, 14, -1);
-      B(0, -3, -7, 15, -2);
-      B(0, -3, -8, 15, -2);
-      B(0, -3, -9, 15, -2);
-
-      B(0, -3, -2, 13, 1);
-      B(0, -3, -1, 13, 2);
-      B(0, -3,  0, 13, 5);
-      B(0, -3,  1, 14, 5);
-      B(0, -3,  2, 18, 4);
-      B(0, -3,  3, 18, 5);
-      B(0, -3,  4, 21, 5);
-      }
+      {  1,   4,   4,  -12,   0 },
+      {  1,  11,  11,  -13,   0 },
+      {  0,   4,   4,   12,   0 },
+      {  0,  -3,  -3,   13,   0 },
+
+      {  1,  11,  10,  -13,  -1 },
+      {  1,  11,   9,  -13,  -2 },
+      {  1,  11,   8,  -13,  -5 },
+      {  1,  11,   7,  -14,  -5 },
+      {  1,  11,   6,  -18,  -4 },
+      {  1,  11,   5,  -18,  -5 },
+      {  1,  11,   4,  -21,  -5 },
+
+      {  1,   4,   3,  -12,  -1 },
+      {  1,   4,   2,  -12,  -4 },
+      {  1,   4,   1,  -14,  -4 },
+      {  1,   4,   0,  -16,  -4 },
+
+      {  1,  11,  12,  -14,   1 },
+      {  1,  11,  13,  -14,   1 },
+      {  1,  11,  14,  -14,   1 },
+      {  1,  11,  15,  -15,   2 },
+      {  1,  11,  16,  -15,   2 },
+
+      {  1,   4,   5,  -12,   1 },
+      {  1,   4,   6,  -12,   4 },
+      {  1,   4,   7,  -12,   5 },
+      {  1,   4,   8,  -12,   5 },
+      {  1,   4,   9,  -13,   6 },
+      {  1,   4,  10,  -12,   4 },
+      {  1,   4,  11,  -12,   5 },
+
+      {  0,   4,   3,   12,  -1 },
+      {  0,   4,   2,   12,  -4 },
+      {  0,   4,   1,   12,  -5 },
+      {  0,   4,   0,   12,  -5 },
+      {  0,   4,  -1,   13,  -6 },
+      {  0,   4,  -2,   12,  -4 },
+      {  0,   4,  -3,   12,  -5 },
+
+      {  0,   4,   5,   12,   1 },
+      {  0,   4,   6,   12,   4 },
+
+      {  0,  -3,  -4,   14,  -1 },
+      {  0,  -3,  -5,   14,  -1 },
+      {  0,  -3,  -6,   14,  -1 },
+      {  0,  -3,  -7,   15,  -2 },
+      {  0,  -3,  -8,   15,  -2 },
+      {  0,  -3,  -9,   15,  -2 },
+
+      {  0,  -3,  -2,   13,   1 },
+      {  0,  -3,  -1,   13,   2 },
+      {  0,  -3,   0,   13,   5 },
+      {  0,  -3,   1,   14,   5 },
+      {  0,  -3,   2,   18,   4 },
+      {  0,  -3,   3,   18,   5 },
+      {  0,  -3,   4,   21,   5 },
+      };
+
+//---------------------------------------------------------
+//   BeamMetricIndex
+//    beamMetrics indexed by (up, step1, step2), built once;
+//    steps outside [MIN_STEP, MIN_STEP + STEPS) are not in
+//    the table
+//---------------------------------------------------------
+
+struct BeamMetricIndex {
+      static const int MIN_STEP = -9;
+      static const int STEPS    = 26;
+      Bm bm[2][STEPS][STEPS];
+
+      BeamMetricIndex()
+            {
+            for (const auto& m : beamMetrics) {
+                  Q_ASSERT(m.l1 >= MIN_STEP && m.l1 < MIN_STEP + STEPS);
+                  Q_ASSERT(m.l2 >= MIN_STEP && m.l2 < MIN_STEP + STEPS);
+                  bm[m.up][m.l1 - MIN_STEP][m.l2 - MIN_STEP] = Bm(m.l, m.s);
+                  }
+            }
+      };
 
 //---------------------------------------------------------
 //   beamMetric1
@@ -1060,12 +1083,12 @@ static void initBeamMetrics()
 
 static Bm beamMetric1(bool up, char l1, char l2)
       {
-      static int initialized = false;
-      if (!initialized) {
-            initBeamMetrics();
-            initialized = true;
-            }
-      return bMetrics[Bm::key(up, l1, l2)];
+      static const BeamMetricIndex index;       // thread safe initialization
+      int i1 = (signed char)l1 - BeamMetricIndex::MIN_STEP;
+      int i2 = (signed char)l2 - BeamMetricIndex::MIN_STEP;
+      if (i1 < 0 || i1 >= BeamMetricIndex::STEPS || i2 < 0 || i2 >= BeamMetricIndex::STEPS)
+            return Bm();
+      return index.bm[up][i1][i2];
       }
 
 //---------------------------------------------------------
@@ -1158,9 +1181,9 @@ static int maxSlant(uint interval)
 //   slantTable
 //---------------------------------------------------------
 
-static int* slantTable(uint interval)
+static const int* slantTable(uint interval)
       {
-      static int t[8][5] = {
+      static const int t[8][5] = {
             { 0, -1,  0,  0,  0 },
             { 1, -1,  0,  0,  0 },
             { 3,  4,  2, -1,  0 },
@@ -1198,6 +1221,19 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
       // shorten stem length if grace notes beam is under main notes beam.
       // Value 4 estimated. Desired: to find a good formula.
 
+      // adjust() only depends on the slant, but the searches below retry
+      // the same slants for up to five stem lengths: evaluate it once per slant
+      int adjustCache[17];
+      std::fill(std::begin(adjustCache), std::end(adjustCache), INT_MIN);
+      auto adjustSlant = [&](int slant) {
+            if (slant < -8 || slant > 8)
+                  return adjust(_spStaff4, slant, cl);
+            int& a = adjustCache[slant + 8];
+            if (a == INT_MIN)
+                  a = adjust(_spStaff4, slant, cl);
+            return a;
+            };
+
       int graceStemLengthCorrection;
       if (_isGrace)
             graceStemLengthCorrection = static_cast<const Chord*>(c1)->underBeam() ? 4 : 3;
@@ -1210,7 +1246,7 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
                   bm.s = 0.0;
 
             // special case for two beamed notes: flatten to max of 1sp
-            static int maxShortSlant = 4;
+            static const int maxShortSlant = 4;
             if (bm.l && elements().size() == 2) {
                   //qDebug("computeStemLen: l = %d, s = %d", (int)bm.l, (int)bm.s);
                   if (bm.s > maxShortSlant) {
@@ -1248,7 +1284,7 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
                         }
                   }
             else {
-                  int* st = slantTable(zeroSlant ? 0 : qAbs((l2 - l1) / 2));
+                  const int* st = slantTable(zeroSlant ? 0 : qAbs((l2 - l1) / 2));
                   int ll1;
                   if (_up) {
                         ll1 = l1 - ((l1 & 3) ? 11 : 12);
@@ -1262,9 +1298,9 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
                               int i;
                               for (i = 0; st[i] != -1; ++i) {
                                     int slant = (l2 > l1) ? st[i] : -st[i];
-                                    int lll1  = qMin(rll1, ll1m - n - adjust(_spStaff4, slant, cl));
+                                    int lll1  = qMin(rll1, ll1m - n - adjustSlant(slant));
                                     int ll2   = lll1 + slant;
-                                    static bool ba[4][4] = {
+                                    static const bool ba[4][4] = {
                                           { true,  true,  false, true },
                                           { true,  true,  false, true },
                                           { false, false, false, true },
@@ -1296,11 +1332,11 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
                               int i;
                               for (i = 0; st[i] != -1; ++i) {
                                     int slant = (l2 > l1) ? st[i] : -st[i];
-                                    int lll1  = qMax(rll1, ll1 + adjust(_spStaff4, slant, cl));
+                                    int lll1  = qMax(rll1, ll1 + adjustSlant(slant));
                                     int e1    = lll1 & 3;
                                     int ll2   = lll1 + slant;
                                     int e2    = ll2 & 3;
-                                    static bool ba[4][4] = {
+                                    static const bool ba[4][4] = {
                                           { true,  true,  false, true },
                                           { true,  true,  false, true },
                                           { false, false, false, true },
@@ -1349,9 +1385,9 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
                         int i;
                         for (i = minS; i <= maxS; ++i) {
                               int slant = (l2 > l1) ? i : -i;
-                              int lll1  = qMin(rll1, ll1 - adjust(_spStaff4, slant, cl));
+                              int lll1  = qMin(rll1, ll1 - adjustSlant(slant));
                               int ll2   = lll1 + slant;
-                              static bool ba[4][4] = {
+                              static const bool ba[4][4] = {
                                     { true,  true,  false, false  },
                                     { true,  true,  false, false },
                                     { false, false, false, false },
@@ -1386,9 +1422,9 @@ void Beam::computeStemLen(const std::vector<ChordRest*>& cl, qreal& py1, int bea
                         int i;
                         for (i = minS; i <= maxS; ++i) {
                               int slant = down ? i : -i;
-                              int lll1  = qMax(rll1, ll1 + adjust(_spStaff4, slant, cl));
+                              int lll1  = qMax(rll1, ll1 + adjustSlant(slant));
                               int ll2   = lll1 + slant;
-                              static bool ba[4][4] = {
+                              static const bool ba[4][4] = {
                                     { true,  false, false, true  },
                                     { false, false, false, false },
                                     { false, false, false, false },
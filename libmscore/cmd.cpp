@@ -1990,11 +1990,12 @@ bool Score::processMidiInput()
                         if (!styleB(Sid::concertPitch)) {
                               ev.pitch += p->instrument(selection().tickStart())->transpose().chromatic;
                               }
-                        MScore::seq->startNote(
-                                          p->instrument()->channel(0)->channel(),
-                                          ev.pitch,
-                                          ev.velocity,
-                                          0.0);
+                        if (!ev.sounded)
+                              MScore::seq->startNote(
+                                                p->instrument()->channel(0)->channel(),
+                                                ev.pitch,
+                                                ev.velocity,
+                                                0.0);
                         }
                   }
             if (noteEntryMode()) {
@@ -1279,6 +1279,8 @@ void Score::hideEmptyStaves(System* system, bool isFirstSystem)
       int staves   = _staves.size();
       int staffIdx = 0;
       bool systemIsEmpty = true;
+      std::vector<bool> nonEmpty;         // computed for all staves on first use
+      std::vector<bool> movedInto;
 
       for (Staff* staff : _staves) {
             SysStaff* ss  = system->staff(staffIdx);
@@ -1290,49 +1292,29 @@ void Score::hideEmptyStaves(System* system, bool isFirstSystem)
                     && (staves > 1)
                     && !(isFirstSystem && styleB(Sid::dontHideStavesInFirstSystem))
                     && hideMode != Staff::HideMode::NEVER)) {
-                  bool hideStaff = true;
-                  for (MeasureBase* m : system->measures()) {
-                        if (!m->isMeasure())
-                              continue;
-                        Measure* measure = toMeasure(m);
-                        if (!measure->isEmpty(staffIdx)) {
-                              hideStaff = false;
-                              break;
+                  if (nonEmpty.empty()) {
+                        nonEmpty.assign(staves, false);
+                        movedInto.assign(staves, false);
+                        for (MeasureBase* mb : system->measures()) {
+                              if (mb->isMeasure())
+                                    toMeasure(mb)->markNonEmptyStaves(nonEmpty, movedInto);
                               }
                         }
+                  bool hideStaff = !nonEmpty[staffIdx];
                   // check if notes moved into this staff
                   Part* part = staff->part();
                   int n = part->nstaves();
                   if (hideStaff && (n > 1)) {
-                        int idx = part->staves()->front()->idx();
-                        for (int i = 0; i < part->nstaves(); ++i) {
-                              int st = idx + i;
-
-                              for (MeasureBase* mb : system->measures()) {
-                                    if (!mb->isMeasure())
-                                          continue;
-                                    Measure* m = toMeasure(mb);
-                                    if (staff->hideWhenEmpty() == Staff::HideMode::INSTRUMENT && !m->isEmpty(st)) {
+                        if (movedInto[staffIdx])
+                              hideStaff = false;
+                        else if (staff->hideWhenEmpty() == Staff::HideMode::INSTRUMENT) {
+                              int idx = part->staves()->front()->idx();
+                              for (int i = 0; i < n; ++i) {
+                                    if (nonEmpty[idx + i]) {
                                           hideStaff = false;
                                           break;
                                           }
-                                    for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
-                                          for (int voice = 0; voice < VOICES; ++voice) {
-                                                ChordRest* cr = s->cr(st * VOICES + voice);
-                                                if (cr == 0 || cr->isRest())
-                                                      continue;
-                                                int staffMove = cr->staffMove();
-                                                if (staffIdx == st + staffMove) {
-                                                      hideStaff = false;
-                                                      break;
-                                                      }
-                                                }
-                                          }
-                                    if (!hideStaff)
-                                          break;
                                     }
-                              if (!hideStaff)
-                                    break;
                               }
                         }
                   ss->setShow(hideStaff ? false : staff->show());
@@ -1558,42 +1540,29 @@ static void layoutPage(Page* page, qreal restHeight)
 
       qreal maxDist = score->styleP(Sid::maxSystemDistance);
 
-      // allocate space as needed to normalize system distance (bottom of one system to top of next)
-      std::sort(sList.begin(), sList.end(), [](System* a, System* b) { return a->distance() - a->height() < b->distance() - b->height(); });
-      System* s0 = sList[0];
-      qreal dist = s0->distance() - s0->height();           // distance for shortest system
-      for (int i = 1; i < sList.size(); ++i) {
-            System* si = sList[i];
-            qreal ndist = si->distance() - si->height();    // next taller system
-            qreal fill  = ndist - dist;                     // amount by which this system distance exceeds next shorter
-            if (fill > 0.0) {
-                  qreal totalFill = fill * i;               // space required to add this amount to all shorter systems
-                  if (totalFill > restHeight) {
-                        totalFill = restHeight;             // too much; adjust amount
-                        fill = restHeight / i;
-                        }
-                  for (int k = 0; k < i; ++k) {             // add amount to all shorter systems
-                        System* s = sList[k];
-                        qreal d = s->distance() + fill;
-                        if ((d - s->height()) > maxDist)    // but don't exceed max system distance
-                              d = qMax(maxDist + s->height(), s->distance());
-                        s->setDistance(d);
-                        }
-                  restHeight -= totalFill;                  // reduce available space for next iteration
-                  if (restHeight <= 0)
-                        break;                              // no space left
-                  }
-            dist = ndist;                                   // set up for next iteration
+      // Allocate space to normalize the system distance (bottom of one system
+      // to top of next): fill the smallest distances up to a common level,
+      // like water poured over the sorted distances, and never raise a
+      // distance above maxDist. The level is found in one pass over the
+      // sorted distances.
+      std::vector<qreal> dl;
+      dl.reserve(sList.size());
+      for (System* s : sList)
+            dl.push_back(s->distance() - s->height());
+      std::sort(dl.begin(), dl.end());
+      const int n = int(dl.size());
+      qreal sum   = 0.0;
+      qreal level = dl.back();
+      for (int i = 0; i < n; ++i) {
+            sum  += dl[i];
+            level = (restHeight + sum) / (i + 1);
+            if (i + 1 == n || level <= dl[i + 1])
+                  break;
             }
-
-      if (restHeight > 0.0) {                               // space left?
-            qreal fill = restHeight / sList.size();
-            for (System* s : sList) {                       // allocate it to systems equally
-                  qreal d = s->distance() + fill;
-                  if ((d - s->height()) > maxDist)          // but don't exceed max system distance
-                        d = qMax(maxDist + s->height(), s->distance());
-                  s->setDistance(d);
-                  }
+      level = qMin(level, maxDist);
+      for (System* s : sList) {
+            if (s->distance() - s->height() < level)
+                  s->setDistance(level + s->height());
             }
 
       qreal y = page->systems().at(0)->y();
@@ -1876,7 +1845,8 @@ void Score::createMMRest(Measure* m, Measure* lm, const Fraction& len)
                               }
                         else {
                               Clef* mmrClef = toClef(mmrClefSeg->element(track));
-                              mmrClef->setClefType(clef->clefType());
+                              if (mmrClef->clefType() != clef->clefType())
+                                    mmrClef->setClefType(clef->clefType());
                               mmrClef->setShowCourtesy(clef->showCourtesy());
                               }
                         }
@@ -1887,33 +1857,41 @@ void Score::createMMRest(Measure* m, Measure* lm, const Fraction& len)
       mmr->setRepeatEnd(m->repeatEnd() || lm->repeatEnd());
       mmr->setSectionBreak(lm->sectionBreak());
 
-      ElementList oldList = mmr->takeElements();
       ElementList newList = lm->el();
 
       for (Element* e : m->el()) {
             if (e->isMarker())
                   newList.push_back(e);
             }
-      for (Element* e : newList) {
-            bool found = false;
-            for (Element* ee : oldList) {
-                  if (ee->type() == e->type()) {
-                        mmr->add(ee);
-                        auto i = std::find(oldList.begin(), oldList.end(), ee);
-                        if (i != oldList.end())
-                              oldList.erase(i);
-                        found = true;
-                        break;
+      // a reused mmrest usually has the elements already: then taking them
+      // out and adding them back would only retrigger layout
+      const ElementList& mmrList = mmr->el();
+      bool sameElements = mmrList.size() == newList.size();
+      for (size_t i = 0; sameElements && i < newList.size(); ++i)
+            sameElements = mmrList[i]->type() == newList[i]->type();
+      if (!sameElements) {
+            ElementList oldList = mmr->takeElements();
+            for (Element* e : newList) {
+                  bool found = false;
+                  for (Element* ee : oldList) {
+                        if (ee->type() == e->type()) {
+                              mmr->add(ee);
+                              auto i = std::find(oldList.begin(), oldList.end(), ee);
+                              if (i != oldList.end())
+                                    oldList.erase(i);
+                              found = true;
+                              break;
+                              }
+                        }
+                  if (!found) {
+                        Element* e1 = e->clone();
+                        e1->setParent(mmr);
+                        undo(new AddElement(e1));
                         }
                   }
-            if (!found) {
-                  Element* e1 = e->clone();
-                  e1->setParent(mmr);
-                  undo(new AddElement(e1));
-                  }
+            for (Element* e : oldList)
+                  delete e;
             }
-      for (Element* e : oldList)
-            delete e;
       Segment* s = mmr->undoGetSegmentR(SegmentType::ChordRest, Fraction(0,1));
       for (int staffIdx = 0; staffIdx < _staves.size(); ++staffIdx) {
             int track = staffIdx * VOICES;
@@ -1974,10 +1952,8 @@ void Score::createMMRest(Measure* m, Measure* lm, const Fraction& len)
                               nts->setParent(ns);
                               undo(new AddElement(nts));
                               }
-                        else {
-                              nts->setSig(ts->sig(), ts->timeSigType());
-                              nts->layout();
-                              }
+                        else
+                              nts->setSig(ts->sig(), ts->timeSigType());      // laid out with the mmrest measure
                         }
                   }
             }
@@ -2004,10 +1980,8 @@ void Score::createMMRest(Measure* m, Measure* lm, const Fraction& len)
                               na->setParent(ns);
                               undo(new AddElement(na));
                               }
-                        else {
-                              na->initFrom(a);
-                              na->layout();
-                              }
+                        else
+                              na->initFrom(a);        // laid out with the mmrest measure
                         }
                   }
             }
@@ -3300,6 +3274,127 @@ static void processLines(System* system, std::vector<Spanner*> lines, bool align
             }
       }
 
+//---------------------------------------------------------
+//   optimalLineBreaks
+//    choose system breaks so that the sum of the squared
+//    free space of all systems but the last, plus a small
+//    penalty per system, is minimal
+//    header[i], core[i], trailer[i] are the widths of measure
+//    i with and without system header and trailer; no break
+//    is placed after a measure with noBreak[i] set.
+//    The first system has firstWidth, the others width.
+//    Returns the index of the last measure of every system,
+//    empty if there is no solution.
+//---------------------------------------------------------
+
+std::vector<int> optimalLineBreaks(const std::vector<qreal>& header, const std::vector<qreal>& core,
+   const std::vector<qreal>& trailer, const std::vector<bool>& noBreak, qreal firstWidth, qreal width)
+      {
+      const int n = int(core.size());
+      const qreal linePenalty = 0.01;
+      const qreal infinity    = std::numeric_limits<qreal>::max();
+      std::vector<qreal> cost(n + 1, infinity);  // cost[k]: best cost for the first k measures
+      std::vector<int> from(n + 1, -1);
+      cost[0] = 0.0;
+      for (int i = 0; i < n; ++i) {             // system starts with measure i
+            if (cost[i] == infinity)
+                  continue;
+            const qreal sw = i == 0 ? firstWidth : width;
+            qreal w = header[i];
+            for (int j = i; j < n; ++j) {       // system ends with measure j
+                  w += core[j];
+                  const qreal lw = w + trailer[j];
+                  if (lw > sw && j > i)
+                        break;
+                  if (j < n - 1 && noBreak[j])
+                        continue;
+                  qreal c = linePenalty;
+                  if (j < n - 1) {
+                        const qreal r = (sw - lw) / sw;
+                        c += r * r;
+                        }
+                  if (cost[i] + c < cost[j + 1]) {
+                        cost[j + 1] = cost[i] + c;
+                        from[j + 1] = i;
+                        }
+                  }
+            }
+      std::vector<int> breaks;
+      if (n == 0 || cost[n] == infinity)
+            return breaks;
+      for (int k = n; k > 0; k = from[k])
+            breaks.push_back(k - 1);
+      std::reverse(breaks.begin(), breaks.end());
+      return breaks;
+      }
+
+//---------------------------------------------------------
+//   planLineBreaks
+//    optimal fit line breaking: choose the system breaks from
+//    start up to the next forced break with optimalLineBreaks().
+//    Uses the measure widths recorded by the last layout; the
+//    plan is a hint for collectSystem(), which still breaks
+//    early if a system does not fit.
+//    firstWidth is the width available in the system being
+//    collected, width the one in the following systems, < 0
+//    if not known yet.
+//---------------------------------------------------------
+
+void Score::planLineBreaks(LayoutContext& lc, MeasureBase* start, qreal firstWidth, qreal width)
+      {
+      lc.lineBreakPlan.clear();
+
+      std::vector<MeasureBase*> mbl;
+      std::vector<qreal> core;            // width without system header and trailer
+      std::vector<qreal> header;
+      std::vector<qreal> trailer;
+      std::vector<bool> noBreak;
+
+      for (MeasureBase* mb = start; mb && mb->isMeasure();) {
+            Measure* m = toMeasure(mb);
+            if (!m->hasLineBreakWidths()) {
+                  lc.lineBreakPlanIncomplete = true;
+                  return;
+                  }
+            mbl.push_back(m);
+            core.push_back(m->lineBreakWidth());
+            header.push_back(m->lineBreakHeaderWidth());
+            trailer.push_back(m->lineBreakTrailerWidth());
+            noBreak.push_back(m->noBreak());
+            if (m->pageBreak() || m->lineBreak() || m->sectionBreak())
+                  break;
+            mb = _showVBox ? m->nextMM() : m->nextMeasureMM();
+            if (mb && mb->isHBox())
+                  return;           // hbox may create a system header: leave it to collectSystem()
+            }
+      if (mbl.empty())
+            return;
+
+      // measures never laid out at the start of a system get the header of the closest one before
+      qreal hw = 0.0;
+      for (qreal h : header) {
+            if (h >= 0.0) {
+                  hw = h;
+                  break;
+                  }
+            }
+      for (qreal& h : header) {
+            if (h < 0.0)
+                  h = hw;
+            else
+                  hw = h;
+            }
+
+      std::vector<int> breaks = optimalLineBreaks(header, core, trailer, noBreak, firstWidth, width < 0.0 ? firstWidth : width);
+      if (width < 0.0 && breaks.size() > 1)
+            lc.lineBreakPlanIncomplete = true;
+      int first = 0;
+      for (int last : breaks) {
+            lc.lineBreakPlan[mbl[first]] = mbl[last];
+            first = last + 1;
+            }
+      }
+
 //---------------------------------------------------------
 //   collectSystem
 //---------------------------------------------------------
@@ -3323,6 +3418,7 @@ System* Score::collectSystem(LayoutContext& lc)
       bool createHeader = false;
       qreal systemWidth = styleD(Sid::pagePrintableWidth) * DPI;
       system->setWidth(systemWidth);
+      const MeasureBase* plannedEnd = 0;
 
       // save state of measure
       qreal curWidth = lc.curMeasure->width();
@@ -3341,6 +3437,22 @@ System* Score::collectSystem(LayoutContext& lc)
                         layoutSystemMinWidth = minWidth;
                         system->layoutSystem(minWidth);
                         minWidth += system->leftMargin();
+                        if (styleB(Sid::lineBreakOptimalFit) && _layoutMode != LayoutMode::FLOAT && _layoutMode != LayoutMode::LINE) {
+                              // systems after the first of a section have short instrument names
+                              if (!lc.startWithLongNames)
+                                    _lineBreakShortMargin = system->leftMargin();
+                              auto i = lc.lineBreakPlan.find(m);
+                              if (i == lc.lineBreakPlan.end()) {
+                                    qreal width = systemWidth - minWidth;
+                                    qreal nextWidth = width;
+                                    if (lc.startWithLongNames)
+                                          nextWidth = _lineBreakShortMargin < 0.0 ? -1.0 : systemWidth - layoutSystemMinWidth - _lineBreakShortMargin;
+                                    planLineBreaks(lc, m, width, nextWidth);
+                                    i = lc.lineBreakPlan.find(m);
+                                    }
+                              if (i != lc.lineBreakPlan.end())
+                                    plannedEnd = i->second;
+                              }
                         if (m->repeatStart()) {
                               Segment* s = m->findSegmentR(SegmentType::StartRepeatBarLine, Fraction(0,1));
                               if (!s->enabled())
@@ -3443,6 +3555,8 @@ System* Score::collectSystem(LayoutContext& lc)
                         lineBreak = false;
                         break;
                   }
+            if (mb == plannedEnd)
+                  lineBreak = true;
 
             // preserve state of next measure (which is about to become current measure)
             if (lc.nextMeasure) {
@@ -3542,6 +3656,11 @@ System* Score::collectSystem(LayoutContext& lc)
                   }
             }
 
+      for (MeasureBase* mb : system->measures()) {
+            if (mb->isMeasure())
+                  toMeasure(mb)->setLineBreakWidths();
+            }
+
       //
       // stretch incomplete row
       //
@@ -3679,9 +3798,16 @@ void Score::layoutSystemElements(System* system, LayoutContext& lc)
 
       //-------------------------------------------------------------
       //    create skylines
+      //    Every staff only reads the layout of its own elements
+      //    and writes its own skyline, so staves can be processed
+      //    concurrently. Small systems are done serially, their
+      //    work does not pay for dispatching to the thread pool.
       //-------------------------------------------------------------
 
-      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+      static const int PARALLEL_SKYLINE_MIN_STAVES   = 4;
+      static const int PARALLEL_SKYLINE_MIN_ELEMENTS = 1024;      // segments * staves
+
+      auto createSkyline = [this, system, &lc](int& staffIdx) {
             SysStaff* ss = system->staff(staffIdx);
             Skyline& skyline = ss->skyline();
             skyline.clear();
@@ -3760,6 +3886,17 @@ void Score::layoutSystemElements(System* system, LayoutContext& lc)
                               }
                         }
                   }
+            };
+      std::vector<int> staves(nstaves());
+      for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx)
+            staves[staffIdx] = staffIdx;
+      if (nstaves() >= PARALLEL_SKYLINE_MIN_STAVES && int(sl.size()) * nstaves() >= PARALLEL_SKYLINE_MIN_ELEMENTS) {
+            ScoreFont::fallbackFont();          // loaded on first use
+            QtConcurrent::blockingMap(staves, createSkyline);
+            }
+      else {
+            for (int& staffIdx : staves)
+                  createSkyline(staffIdx);
             }
 
       //-------------------------------------------------------------
@@ -4533,6 +4670,18 @@ void Score::doLayoutRange(const Fraction& st, const Fraction& et)
 
       lc.layout();
 
+      // the optimal fit line breaker found measures without recorded
+      // widths; now that all have one, do the layout again
+      if (layoutAll && lc.lineBreakPlanIncomplete && !_lineBreakRetry) {
+            for (Spanner* s : lc.processedSpanners)
+                  s->layoutSystemsDone();
+            lc.processedSpanners.clear();
+            _lineBreakRetry = true;
+            doLayoutRange(st, et);
+            _lineBreakRetry = false;
+            return;
+            }
+
       for (MuseScoreView* v : viewer)
             v->layoutChanged();
       }
@@ -48,6 +48,9 @@ struct LayoutContext {
       Fraction startTick;
       Fraction endTick;
 
+      std::map<const MeasureBase*, const MeasureBase*> lineBreakPlan;   // first -> last measure of planned systems
+      bool lineBreakPlanIncomplete { false };
+
       LayoutContext() = default;
       LayoutContext(const LayoutContext&) = delete;
       LayoutContext& operator=(const LayoutContext&) = delete;
@@ -76,6 +79,8 @@ extern bool isTopBeam(ChordRest* cr);
 extern bool notTopBeam(ChordRest* cr);
 extern bool isTopTuplet(ChordRest* cr);
 extern bool notTopTuplet(ChordRest* cr);
+extern std::vector<int> optimalLineBreaks(const std::vector<qreal>& header, const std::vector<qreal>& core,
+   const std::vector<qreal>& trailer, const std::vector<bool>& noBreak, qreal firstWidth, qreal width);
 
 }     // namespace Ms
 #endif
@@ -215,6 +215,9 @@ Measure::Measure(Score* s)
       _breakMultiMeasureRest    = false;
       _mmRest                   = 0;
       _mmRestCount              = 0;
+      _lineBreakWidth           = -1.0;
+      _lineBreakHeaderWidth     = -1.0;
+      _lineBreakTrailerWidth    = 0.0;
       setFlag(ElementFlag::MOVABLE, true);
       }
 
@@ -239,6 +242,9 @@ Measure::Measure(const Measure& m)
       _mmRest                = m._mmRest;
       _mmRestCount           = m._mmRestCount;
       _playbackCount         = m._playbackCount;
+      _lineBreakWidth        = -1.0;
+      _lineBreakHeaderWidth  = -1.0;
+      _lineBreakTrailerWidth = 0.0;
       }
 
 //---------------------------------------------------------
@@ -2696,6 +2702,42 @@ bool Measure::isEmpty(int staffIdx) const
       return true;
       }
 
+//---------------------------------------------------------
+//   markNonEmptyStaves
+//    same as !isEmpty(staffIdx) for all staves in one pass:
+//    set nonEmpty[staffIdx] for every staff with notes or
+//    annotations, and movedInto[staffIdx] for every staff
+//    which gets notes moved in from another staff
+//---------------------------------------------------------
+
+void Measure::markNonEmptyStaves(std::vector<bool>& nonEmpty, std::vector<bool>& movedInto) const
+      {
+      const int nstaves = score()->nstaves();
+      for (Segment* s = first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+            const std::vector<Element*>& el = s->elist();
+            const int tracks = qMin(int(el.size()), nstaves * VOICES);
+            for (int track = 0; track < tracks; ++track) {
+                  Element* e = el[track];
+                  if (!e || e->isRest())
+                        continue;
+                  int staffIdx = track / VOICES;
+                  nonEmpty[staffIdx] = true;
+                  if (e->isChordRest()) {
+                        int st = staffIdx + toChordRest(e)->staffMove();
+                        if (st != staffIdx && st >= 0 && st < nstaves)
+                              movedInto[st] = true;
+                        }
+                  }
+            for (Element* a : s->annotations()) {
+                  if (!a || a->systemFlag() || !a->visible() || a->isFermata())
+                        continue;
+                  int atrack = a->track();
+                  if (atrack >= 0 && atrack < nstaves * VOICES)
+                        nonEmpty[atrack / VOICES] = true;
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   isFullMeasureRest
 //    Check for an empty measure, filled with full measure
@@ -4090,6 +4132,49 @@ static bool hasAccidental(Segment* s)
       return false;
       }
 
+//---------------------------------------------------------
+//   SpacingEdge
+//    running right edge profile of the segments already
+//    placed by computeMinWidth(): prefix maxima (from the
+//    first segment on) of the segment position and of the
+//    right border of its shapes
+//---------------------------------------------------------
+
+struct SpacingEdge {
+      Segment* segment;
+      qreal maxX;
+      qreal maxRight;
+      };
+
+static qreal segmentRight(const Segment* s)
+      {
+      qreal r = 0.0;
+      for (const Shape& sh : s->shapes())
+            r = qMax(r, sh.right());
+      return r;
+      }
+
+static qreal segmentLeft(const Segment* s)
+      {
+      qreal l = 1000000.0;
+      for (const Shape& sh : s->shapes()) {
+            for (const ShapeElement& r : sh)
+                  l = qMin(l, r.left());
+            }
+      return l;
+      }
+
+static void appendSpacingEdge(std::vector<SpacingEdge>& profile, Segment* s)
+      {
+      qreal mx = s->x();
+      qreal mr = s->x() + segmentRight(s);
+      if (!profile.empty()) {
+            mx = qMax(mx, profile.back().maxX);
+            mr = qMax(mr, profile.back().maxRight);
+            }
+      profile.push_back({ s, mx, mr });
+      }
+
 //---------------------------------------------------------
 //   computeMinWidth
 //    sets the minimum stretched width of segment list s
@@ -4118,6 +4203,22 @@ void Measure::computeMinWidth(Segment* s, qreal x, bool isSystemHeader)
                   }
             }
 
+      // profile of all active segments from fs up to s, see below
+      std::vector<SpacingEdge> profile;
+      bool useProfile = true;
+      if (s != fs) {
+            std::vector<Segment*> sl;
+            for (Segment* ps = s->prevActive(); ps; ps = ps->prevActive()) {
+                  sl.push_back(ps);
+                  if (ps == fs)
+                        break;
+                  }
+            if (!sl.empty() && sl.back() == fs) {
+                  for (auto i = sl.rbegin(); i != sl.rend(); ++i)
+                        appendSpacingEdge(profile, *i);
+                  }
+            }
+
       while (s) {
             s->rxpos() = x;
             if (!s->enabled() || !s->visible()) {
@@ -4143,10 +4244,18 @@ void Measure::computeMinWidth(Segment* s, qreal x, bool isSystemHeader)
 // printf("  min %f <%s>(%d) <%s>(%d)\n", s->x(), s->subTypeName(), s->enabled(), ns->subTypeName(), ns->enabled());
 #if 1
                   // look back for collisions with previous segments
-                  // this is time consuming (ca. +5%) and probably requires more optimization
 
+                  const qreal fsDistance = ns->minLeft(ls) - s->x();
                   if (s == fs) // don't let the second segment cross measure start (not covered by the loop below)
-                        w = std::max(w, ns->minLeft(ls) - s->x());
+                        w = std::max(w, fsDistance);
+
+                  // No segment in front of ps can collide with ns if the profile up to ps
+                  // does not reach into ns. This stops the look back early in the
+                  // common case without changing the result.
+                  const qreal nsLeft = segmentLeft(ns);
+                  const bool canStop = useProfile && fsDistance <= w;
+                  const qreal eps    = 0.001;
+                  int pi = int(profile.size());
 
                   int n = 1;
                   for (Segment* ps = s; ps != fs;) {
@@ -4157,12 +4266,21 @@ void Measure::computeMinWidth(Segment* s, qreal x, bool isSystemHeader)
                         if (!ps)
                               break;
 
+                        --pi;
+                        if (useProfile && (pi < 0 || profile[pi].segment != ps))
+                              useProfile = false;     // profile out of sync, don't use it anymore
+                        if (canStop && useProfile) {
+                              const SpacingEdge& e = profile[pi];
+                              if (qMax(e.maxX, e.maxRight - nsLeft) - s->x() + eps <= w)
+                                    break;
+                              }
+
                         if (ps->isChordRestType())
                               ++n;
                         ww = ps->minHorizontalCollidingDistance(ns) - (s->x() - ps->x());
 
                         if (ps == fs)
-                              ww = std::max(ww, ns->minLeft(ls) - s->x());
+                              ww = std::max(ww, fsDistance);
 
                         if (ww > w) {
                               // overlap !
@@ -4185,6 +4303,15 @@ void Measure::computeMinWidth(Segment* s, qreal x, bool isSystemHeader)
                                     }
                               w += d;
                               x = xx;
+                              // segments behind ps have moved
+                              if (useProfile) {
+                                    std::vector<Segment*> moved;
+                                    for (int i = pi + 1; i < int(profile.size()); ++i)
+                                          moved.push_back(profile[i].segment);
+                                    profile.resize(pi + 1);
+                                    for (Segment* ms : moved)
+                                          appendSpacingEdge(profile, ms);
+                                    }
                               break;
                               }
                         }
@@ -4193,12 +4320,153 @@ void Measure::computeMinWidth(Segment* s, qreal x, bool isSystemHeader)
             else
                   w = s->minRight();
             s->setWidth(w);
+            if (useProfile)
+                  appendSpacingEdge(profile, s);
             x += w;
             s = s->next();
             }
       setStretchedWidth(x);
       }
 
+//---------------------------------------------------------
+//   MinWidthKey
+//    FNV-1a hash over everything computeMinWidth() reads
+//---------------------------------------------------------
+
+class MinWidthKey {
+      quint64 _h { 14695981039346656037ULL };
+
+   public:
+      void add(quint64 v) {
+            for (int i = 0; i < 8; ++i) {
+                  _h ^= (v >> (i * 8)) & 0xff;
+                  _h *= 1099511628211ULL;
+                  }
+            }
+      void add(int v)   { add(quint64(qint64(v))); }
+      void add(bool v)  { add(quint64(v)); }
+      void add(qreal v) {
+            quint64 b;
+            memcpy(&b, &v, sizeof(b));
+            add(b);
+            }
+      void add(const QRectF& r) {
+            add(r.x());
+            add(r.y());
+            add(r.width());
+            add(r.height());
+            }
+      quint64 value() const { return _h; }
+      };
+
+//---------------------------------------------------------
+//   minWidthKey
+//    s is the first enabled segment
+//---------------------------------------------------------
+
+quint64 Measure::minWidthKey(Segment* s) const
+      {
+      static const Sid styles[] = {
+            Sid::noteBarDistance, Sid::barNoteDistance, Sid::barAccidentalDistance, Sid::minNoteDistance,
+            Sid::clefLeftMargin, Sid::keysigLeftMargin, Sid::timesigLeftMargin, Sid::midClefKeyRightMargin,
+            Sid::systemHeaderDistance, Sid::systemHeaderTimeSigDistance, Sid::clefKeyDistance,
+            Sid::clefTimesigDistance, Sid::clefBarlineDistance, Sid::keyTimesigDistance,
+            Sid::keyBarlineDistance, Sid::timesigBarlineDistance, Sid::ambitusMargin, Sid::endBarWidth
+            };
+      MinWidthKey key;
+      for (Sid sid : styles)
+            key.add(score()->styleP(sid));
+      key.add(spatium());
+      key.add(mag());
+      key.add(score()->noteHeadWidth());
+      key.add(system()->firstMeasure() == this);
+      key.add(s->isChordRestType() && hasAccidental(s));
+
+      bool repeatOverlap = false;
+      if (s->isStartRepeatBarLineType()) {
+            MeasureBase* pmb = prev();
+            if (pmb->isMeasure() && pmb->system() == system() && pmb->repeatEnd())
+                  repeatOverlap = toMeasure(pmb)->last()->isEndBarLineType();
+            }
+      key.add(repeatOverlap);
+
+      const int tracks = score()->nstaves() * VOICES;
+      for (Segment* seg = first(); seg; seg = seg->next()) {
+            key.add(int(seg->segmentType()));
+            key.add(seg->enabled());
+            key.add(seg->visible());
+            key.add(seg->header());
+            key.add(seg->extraLeadingSpace().val());
+            if (seg->isChordRestType()) {
+                  bool isGap = false;
+                  for (int i = 0; i < tracks; ++i) {
+                        Element* el = seg->element(i);
+                        if (!el)
+                              continue;
+                        isGap = el->isRest() && toRest(el)->isGap();
+                        if (!isGap)
+                              break;
+                        }
+                  key.add(isGap);
+                  }
+            else if (seg->isStartRepeatBarLineType()) {
+                  Element* barLine = seg->element(0);
+                  key.add(barLine ? barLine->width() : 0.0);
+                  }
+            for (const Shape& sh : seg->shapes()) {
+                  key.add(int(sh.size()));
+                  for (const ShapeElement& r : sh)
+                        key.add(r);
+                  }
+            }
+      return key.value();
+      }
+
+//---------------------------------------------------------
+//   restoreMinWidth
+//    restore segment positions and width from a previous
+//    computeMinWidth() with the same input
+//---------------------------------------------------------
+
+bool Measure::restoreMinWidth(quint64 key)
+      {
+      for (auto i = _minWidthCache.begin(); i != _minWidthCache.end(); ++i) {
+            if (i->key != key)
+                  continue;
+            auto sp = i->segments.begin();
+            for (Segment* seg = first(); seg; seg = seg->next()) {
+                  if (sp == i->segments.end())
+                        return false;
+                  seg->rxpos() = sp->first;
+                  seg->setWidth(sp->second);
+                  ++sp;
+                  }
+            setStretchedWidth(i->width);
+            std::rotate(_minWidthCache.begin(), i, i + 1);    // most recently used first
+            return true;
+            }
+      return false;
+      }
+
+//---------------------------------------------------------
+//   storeMinWidth
+//---------------------------------------------------------
+
+void Measure::storeMinWidth(quint64 key)
+      {
+      const size_t maxEntries = 4;
+      if (_minWidthCache.size() >= maxEntries)
+            _minWidthCache.pop_back();
+      MinWidthCacheEntry e;
+      e.key = key;
+      e.width = 0.0;
+      for (Segment* seg = first(); seg; seg = seg->next()) {
+            e.segments.emplace_back(seg->x(), seg->width());
+            e.width = seg->x() + seg->width();
+            }
+      _minWidthCache.insert(_minWidthCache.begin(), std::move(e));
+      }
+
 void Measure::computeMinWidth()
       {
       Segment* s;
@@ -4214,6 +4482,16 @@ void Measure::computeMinWidth()
             setWidth(0.0);
             return;
             }
+
+      // mm rests are laid out again by computeMinWidth(s, x, isSystemHeader)
+      const bool useCache = !isMMRest();
+      quint64 key = 0;
+      if (useCache) {
+            key = minWidthKey(s);
+            if (restoreMinWidth(key))
+                  return;
+            }
+
       qreal x;
       bool first = system()->firstMeasure() == this;
 
@@ -4247,6 +4525,37 @@ void Measure::computeMinWidth()
       bool isSystemHeader = s->header();
 
       computeMinWidth(s, x, isSystemHeader);
+      if (useCache)
+            storeMinWidth(key);
+      }
+
+//---------------------------------------------------------
+//   setLineBreakWidths
+//    record the width of the measure without system header
+//    and trailer, and the width of header and trailer, for
+//    Score::planLineBreaks(); called after the measure
+//    got its place in a system, before stretching
+//---------------------------------------------------------
+
+void Measure::setLineBreakWidths()
+      {
+      qreal headerWidth  = 0.0;
+      qreal trailerWidth = 0.0;
+      for (Segment* s = first(); s; s = s->next()) {
+            if (!s->enabled())
+                  continue;
+            if (s->header())
+                  headerWidth += s->width();
+            else if (s->trailer())
+                  trailerWidth += s->width();
+            }
+      _lineBreakWidth = width() - headerWidth - trailerWidth;
+      if (header())
+            _lineBreakHeaderWidth = headerWidth;
+      // courtesy elements depend on the next measure only, keep the
+      // last known value if this measure does not end a system
+      if (system() && system()->lastMeasure() == this)
+            _lineBreakTrailerWidth = trailerWidth;
       }
 
 }
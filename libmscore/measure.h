@@ -83,11 +83,28 @@ class Measure final : public MeasureBase {
       MeasureNumberMode _noMode;
       bool _breakMultiMeasureRest;
 
+      // results of computeMinWidth() for the last few segment configurations
+      // (with/without system header, trailer, courtesy elements)
+      struct MinWidthCacheEntry {
+            quint64 key;
+            qreal width;
+            std::vector<std::pair<qreal, qreal>> segments;  // x position and width
+            };
+      std::vector<MinWidthCacheEntry> _minWidthCache;
+
+      // widths recorded by the last system layout for the optimal fit line breaker
+      qreal _lineBreakWidth;              // < 0 if not laid out yet
+      qreal _lineBreakHeaderWidth;        // < 0 if never laid out with a system header
+      qreal _lineBreakTrailerWidth;
+
       void push_back(Segment* e);
       void push_front(Segment* e);
 
       void fillGap(const Fraction& pos, const Fraction& len, int track, const Fraction& stretch);
       void computeMinWidth(Segment* s, qreal x, bool isSystemHeader);
+      quint64 minWidthKey(Segment* s) const;
+      bool restoreMinWidth(quint64 key);
+      void storeMinWidth(quint64 key);
 
       void readVoice(XmlReader& e, int staffIdx, bool irregular);
 
@@ -211,6 +228,7 @@ class Measure final : public MeasureBase {
       void checkMultiVoices(int staffIdx);
       bool hasVoice(int track) const;
       bool isEmpty(int staffIdx) const;
+      void markNonEmptyStaves(std::vector<bool>& nonEmpty, std::vector<bool>& movedInto) const;
       bool isFullMeasureRest() const;
       bool isRepeatMeasure(const Staff* staff) const;
       bool visible(int staffIdx) const;
@@ -261,6 +279,11 @@ class Measure final : public MeasureBase {
       qreal basicWidth() const;
       int layoutWeight(int maxMMRestLength = 0) const;
       virtual void computeMinWidth();
+      void setLineBreakWidths();
+      bool hasLineBreakWidths() const           { return _lineBreakWidth >= 0.0;   }
+      qreal lineBreakWidth() const              { return _lineBreakWidth;          }
+      qreal lineBreakHeaderWidth() const        { return _lineBreakHeaderWidth;    }
+      qreal lineBreakTrailerWidth() const       { return _lineBreakTrailerWidth;   }
       void checkHeader();
       void checkTrailer();
       void setStretchedWidth(qreal);
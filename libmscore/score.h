@@ -189,6 +189,7 @@ struct MidiInputEvent {
       int pitch;
       bool chord;
       int velocity;
+      bool sounded = false;   // already sent to the synthesizer by the midi input thread
       };
 
 //---------------------------------------------------------
@@ -450,6 +451,8 @@ class Score : public QObject, public ScoreElement {
       PlayMode _playMode { PlayMode::SYNTHESIZER };
 
       qreal _noteHeadWidth { 0.0 };       // cached value
+      bool _lineBreakRetry { false };     // doLayoutRange() is repeated for the optimal fit line breaker
+      qreal _lineBreakShortMargin { -1.0 };     // left margin of systems with short instrument names, < 0 if unknown
       QString accInfo;                    ///< information used by the screen-reader
 
       //------------------
@@ -578,6 +581,7 @@ class Score : public QObject, public ScoreElement {
       void setExcerpt(Excerpt* e)   { _excerpt = e;     }
 
       System* collectSystem(LayoutContext&);
+      void planLineBreaks(LayoutContext&, MeasureBase*, qreal, qreal);
       void layoutSystemElements(System* system, LayoutContext& lc);
       void getNextMeasure(LayoutContext&);      // get next measure for layout
 
@@ -1851,15 +1851,82 @@ QString Segment::accessibleExtraInfo() const
       return rez + " " + startSpanners + " " + endSpanners;
       }
 
+//---------------------------------------------------------
+//   addAnnotationShape
+//    add the shape of annotation e of segment seg to the
+//    staff shape s
+//---------------------------------------------------------
+
+static void addAnnotationShape(const Segment* seg, Shape& s, Element* e)
+      {
+      if (!e->addToSkyline())
+            return;
+
+      if (e->isHarmony()) {
+            // use same spacing calculation as for chordrest
+            toHarmony(e)->layout1();
+            const qreal margin = seg->styleP(Sid::minHarmonyDistance) * 0.5;
+            qreal x1 = e->bbox().x() - margin + e->pos().x();
+            qreal x2 = e->bbox().x() + e->bbox().width() + margin + e->pos().x();
+            s.addHorizontalSpacing(Shape::SPACING_HARMONY, x1, x2);
+            }
+      else if (!e->isRehearsalMark()
+         && !e->isFretDiagram()
+         && !e->isHarmony()
+         && !e->isTempoText()
+         && !e->isDynamic()
+         && !e->isFiguredBass()
+         && !e->isSymbol()
+         && !e->isFSymbol()
+         && !e->isSystemText()
+         && !e->isInstrumentChange()
+         && !e->isArticulation()
+         && !e->isFermata()
+         && !e->isStaffText()) {
+            // annotations added here are candidates for collision detection
+            // lyrics, ...
+            s.add(e->shape().translated(e->pos()));
+            }
+      }
+
 //---------------------------------------------------------
 //   createShapes
+//    same as createShape() for every staff, but visits
+//    every element only once
 //---------------------------------------------------------
 
 void Segment::createShapes()
       {
       setVisible(false);
-      for (int staffIdx = 0; staffIdx < score()->nstaves(); ++staffIdx)
-            createShape(staffIdx);
+      const int nstaves = score()->nstaves();
+      if (segmentType() & (SegmentType::BarLine | SegmentType::EndBarLine | SegmentType::StartRepeatBarLine | SegmentType::BeginBarLine)) {
+            for (int staffIdx = 0; staffIdx < nstaves; ++staffIdx)
+                  createShape(staffIdx);
+            return;
+            }
+      for (int staffIdx = 0; staffIdx < nstaves; ++staffIdx)
+            _shapes[staffIdx].clear();
+
+      for (Element* e : _elist) {
+            if (!e)
+                  continue;
+            int staffIdx = e->vStaffIdx();
+            if (staffIdx < 0 || staffIdx >= nstaves || !score()->staff(staffIdx)->show())
+                  continue;
+            setVisible(true);
+            if (e->addToSkyline())
+                  _shapes[staffIdx].add(e->shape().translated(e->pos()));
+            }
+
+      for (Element* e : _annotations) {
+            if (!e)
+                  continue;
+            int staffIdx = e->staffIdx();
+            if (staffIdx < 0 || staffIdx >= nstaves || !score()->staff(staffIdx)->show())
+                  continue;
+            setVisible(true);
+            addAnnotationShape(this, _shapes[staffIdx], e);
+            }
       }
 
 //---------------------------------------------------------
@@ -1914,34 +1981,7 @@ void Segment::createShape(int staffIdx)
             if (!e || e->staffIdx() != staffIdx)
                   continue;
             setVisible(true);
-            if (!e->addToSkyline())
-                  continue;
-
-            if (e->isHarmony()) {
-                  // use same spacing calculation as for chordrest
-                  toHarmony(e)->layout1();
-                  const qreal margin = styleP(Sid::minHarmonyDistance) * 0.5;
-                  qreal x1 = e->bbox().x() - margin + e->pos().x();
-                  qreal x2 = e->bbox().x() + e->bbox().width() + margin + e->pos().x();
-                  s.addHorizontalSpacing(Shape::SPACING_HARMONY, x1, x2);
-                  }
-            else if (!e->isRehearsalMark()
-               && !e->isFretDiagram()
-               && !e->isHarmony()
-               && !e->isTempoText()
-               && !e->isDynamic()
-               && !e->isFiguredBass()
-               && !e->isSymbol()
-               && !e->isFSymbol()
-               && !e->isSystemText()
-               && !e->isInstrumentChange()
-               && !e->isArticulation()
-               && !e->isFermata()
-               && !e->isStaffText()) {
-                  // annotations added here are candidates for collision detection
-                  // lyrics, ...
-                  s.add(e->shape().translated(e->pos()));
-                  }
+            addAnnotationShape(this, s, e);
             }
       }
 
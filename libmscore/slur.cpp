@@ -264,6 +264,12 @@ void SlurSegment::endEdit(EditData& ed)
 
 void SlurSegment::computeBezier(QPointF p6o)
       {
+      // a shoulder offset modifies the bezier offsets and is never cached
+      const bool cacheable = p6o.isNull();
+      const BezierKey key  = bezierKey(_extraHeight);
+      if (cacheable && restoreBezier(key))
+            return;
+
       qreal _spatium  = spatium();
       qreal shoulderW;              // height as fraction of slur-length
       qreal shoulderH;
@@ -391,6 +397,8 @@ void SlurSegment::computeBezier(QPointF p6o)
             _shape.add(re);
             start = point;
             }
+      if (cacheable)
+            storeBezier(key);
       }
 
 //---------------------------------------------------------
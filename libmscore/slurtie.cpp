@@ -17,6 +17,7 @@
 #include "slurtie.h"
 #include "tie.h"
 #include "chord.h"
+#include "staff.h"
 
 namespace Ms {
 
@@ -81,6 +82,64 @@ void SlurTieSegment::move(const QPointF& s)
             _ups[k].p += s;
       }
 
+//---------------------------------------------------------
+//   bezierKey
+//    all inputs of computeBezier() apart from the
+//    shoulder offset; extra is segment type specific
+//---------------------------------------------------------
+
+SlurTieSegment::BezierKey SlurTieSegment::bezierKey(qreal extra) const
+      {
+      qreal w = score()->styleP(Sid::SlurMidWidth) - score()->styleP(Sid::SlurEndWidth);
+      if (staff())
+            w *= staff()->mag(slurTie()->tick());
+      const UP& u1 = ups(Grip::START);
+      const UP& u2 = ups(Grip::END);
+      const UP& b1 = ups(Grip::BEZIER1);
+      const UP& b2 = ups(Grip::BEZIER2);
+      return BezierKey { {
+            u1.p.x(),  u1.p.y(),  u1.off.x(), u1.off.y(),
+            u2.p.x(),  u2.p.y(),  u2.off.x(), u2.off.y(),
+            b1.off.x(), b1.off.y(), b2.off.x(), b2.off.y(),
+            spatium(), w, extra,
+            qreal(slurTie()->up()), qreal(slurTie()->lineType())
+            } };
+      }
+
+//---------------------------------------------------------
+//   restoreBezier
+//    return false if the curve has to be recomputed
+//---------------------------------------------------------
+
+bool SlurTieSegment::restoreBezier(const BezierKey& key)
+      {
+      if (!_bezierCache.valid || _bezierCache.key != key)
+            return false;
+      path      = _bezierCache.path;
+      shapePath = _bezierCache.shapePath;
+      _shape    = _bezierCache.shape;
+      for (int i = 0; i < int(Grip::GRIPS); ++i) {
+            if (i != int(Grip::START))
+                  _ups[i].p = _bezierCache.p[i];
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   storeBezier
+//---------------------------------------------------------
+
+void SlurTieSegment::storeBezier(const BezierKey& key)
+      {
+      _bezierCache.valid     = true;
+      _bezierCache.key       = key;
+      _bezierCache.path      = path;
+      _bezierCache.shapePath = shapePath;
+      _bezierCache.shape     = _shape;
+      for (int i = 0; i < int(Grip::GRIPS); ++i)
+            _bezierCache.p[i] = _ups[i].p;
+      }
+
 //---------------------------------------------------------
 //   spatiumChanged
 //---------------------------------------------------------
@@ -78,6 +78,22 @@ class SlurTie;
 //---------------------------------------------------------
 
 class SlurTieSegment : public SpannerSegment {
+   public:
+      typedef std::array<qreal, 17> BezierKey;
+
+   private:
+      // result of the last computeBezier() together with its inputs;
+      // layout usually recomputes the same curve for unchanged anchors
+      struct BezierCache {
+            bool valid { false };
+            BezierKey key;
+            QPainterPath path;
+            QPainterPath shapePath;
+            Shape shape;
+            QPointF p[int(Grip::GRIPS)];
+            };
+      BezierCache _bezierCache;
+
    protected:
       struct UP _ups[int(Grip::GRIPS)];
 
@@ -88,6 +104,10 @@ class SlurTieSegment : public SpannerSegment {
       virtual void changeAnchor(EditData&, Element*) = 0;
       virtual QPointF gripAnchor(Grip grip) const override;
 
+      BezierKey bezierKey(qreal extra) const;
+      bool restoreBezier(const BezierKey& key);
+      void storeBezier(const BezierKey& key);
+
    public:
       SlurTieSegment(Score*);
       SlurTieSegment(const SlurTieSegment&);
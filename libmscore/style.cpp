@@ -211,6 +211,7 @@ static const StyleType styleTypes[] {
       { Sid::articulationAnchorLuteFingering, "articulationAnchorLuteFingering", int(ArticulationAnchor::BOTTOM_CHORD) },
       { Sid::articulationAnchorOther, "articulationAnchorOther", int(ArticulationAnchor::TOP_STAFF) },
       { Sid::lastSystemFillLimit,     "lastSystemFillLimit",     QVariant(0.3) },
+      { Sid::lineBreakOptimalFit,     "lineBreakOptimalFit",     QVariant(false) },
 
       { Sid::hairpinPlacement,        "hairpinPlacement",        int(Placement::BELOW)  },
       { Sid::hairpinPosAbove,         "hairpinPosAbove",         QPointF(0.0, -3.5) },
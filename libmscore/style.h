@@ -183,6 +183,7 @@ enum class Sid {
       articulationAnchorLuteFingering,
       articulationAnchorOther,
       lastSystemFillLimit,
+      lineBreakOptimalFit,
 
       hairpinPlacement,
       hairpinPosAbove,
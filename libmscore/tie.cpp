@@ -201,6 +201,12 @@ void TieSegment::editDrag(EditData& ed)
 
 void TieSegment::computeBezier(QPointF p6o)
       {
+      // a shoulder offset modifies the bezier offsets and is never cached
+      const bool cacheable = p6o.isNull();
+      const BezierKey key  = bezierKey(qreal(staff()->isTabStaff(slurTie()->tick())));
+      if (cacheable && restoreBezier(key))
+            return;
+
       qreal _spatium  = spatium();
       qreal shoulderW;              // height as fraction of slur-length
       qreal shoulderH;
@@ -329,6 +335,8 @@ void TieSegment::computeBezier(QPointF p6o)
             _shape.add(re);
             start = point;
             }
+      if (cacheable)
+            storeBezier(key);
       }
 
 //---------------------------------------------------------
@@ -63,6 +63,31 @@ MidiFile::MidiFile()
       _noRunningStatus = false;
       }
 
+//---------------------------------------------------------
+//   MidiTrackEncoder
+//    serializes one track into a memory buffer; keeps
+//    its own running status so that several tracks can
+//    be encoded at the same time
+//---------------------------------------------------------
+
+class MidiTrackEncoder {
+      QByteArray& buf;
+      int status;
+      bool noRunningStatus;
+
+      void put(unsigned char c)           { buf.append(char(c)); }
+      void write(const void* p, int len)  { buf.append(static_cast<const char*>(p), len); }
+      void writeStatus(int type, int channel);
+      void writeEvent(const MidiEvent& event);
+
+   public:
+      MidiTrackEncoder(QByteArray& b, bool nrs) : buf(b), status(-1), noRunningStatus(nrs) {}
+      void putvl(unsigned);
+      void writeShort(int);
+      void writeLong(int);
+      void writeTrack(const MidiTrack&);
+      };
+
 //---------------------------------------------------------
 //   write
 //    returns true on error
@@ -71,23 +96,69 @@ MidiFile::MidiFile()
 bool MidiFile::write(QIODevice* out)
       {
       fp = out;
-      write("MThd", 4);
-      writeLong(6);                 // header len
-      writeShort(_format);          // format
-      writeShort(_tracks.size());
-      writeShort(_division);
-      for (const auto &t: _tracks) {
-            if (writeTrack(t))
+      const int ntracks = _tracks.size();
+
+      //
+      // tracks are independent of each other, so encode
+      // them concurrently and write out in order
+      //
+      QVector<QByteArray> chunks(ntracks);
+      if (ntracks > 1) {
+            QVector<int> idx(ntracks);
+            for (int i = 0; i < ntracks; ++i)
+                  idx[i] = i;
+            const QList<MidiTrack>& tracks = _tracks;
+            QByteArray* dst = chunks.data();
+            const bool nrs  = _noRunningStatus;
+            QtConcurrent::blockingMap(idx, [&tracks, dst, nrs](int& i) {
+                  dst[i] = encodeTrack(tracks.at(i), nrs);
+                  });
+            }
+      else if (ntracks == 1)
+            chunks[0] = encodeTrack(_tracks[0], _noRunningStatus);
+
+      QByteArray header;
+      header.reserve(14);
+      header.append("MThd", 4);
+      MidiTrackEncoder he(header, _noRunningStatus);
+      he.writeLong(6);              // header len
+      he.writeShort(_format);       // format
+      he.writeShort(ntracks);
+      he.writeShort(_division);
+
+      if (fp->write(header) != header.size()) {
+            qDebug("write midifile failed: %s", fp->errorString().toLatin1().data());
+            return true;
+            }
+      for (const QByteArray& chunk : chunks) {
+            if (fp->write(chunk) != chunk.size()) {
+                  qDebug("write midifile failed: %s", fp->errorString().toLatin1().data());
                   return true;
+                  }
             }
       return false;
       }
 
 //---------------------------------------------------------
-//   write
+//   encodeTrack
+//    return a complete "MTrk" chunk for track t
+//---------------------------------------------------------
+
+QByteArray MidiFile::encodeTrack(const MidiTrack& t, bool noRunningStatus)
+      {
+      QByteArray buf;
+      // most channel events need 3 or 4 bytes including delta time
+      buf.reserve(8 + 4 * int(t.events().size()) + 16);
+      MidiTrackEncoder enc(buf, noRunningStatus);
+      enc.writeTrack(t);
+      return buf;
+      }
+
+//---------------------------------------------------------
+//   writeEvent
 //---------------------------------------------------------
 
-void MidiFile::writeEvent(const MidiEvent& event)
+void MidiTrackEncoder::writeEvent(const MidiEvent& event)
       {
       switch(event.type()) {
             case ME_NOTEON:
@@ -131,7 +202,7 @@ void MidiFile::writeEvent(const MidiEvent& event)
                   put(event.metaType());
                   putvl(event.len());
                   write(event.edata(), event.len());
-                  resetRunningStatus();     // really ?!
+                  status = -1;      // really ?!
                   break;
 
             case ME_SYSEX:
@@ -139,7 +210,7 @@ void MidiFile::writeEvent(const MidiEvent& event)
                   putvl(event.len() + 1);  // including 0xf7
                   write(event.edata(), event.len());
                   put(ME_ENDSYSEX);
-                  resetRunningStatus();
+                  status = -1;
                   break;
             }
       }
@@ -148,15 +219,15 @@ void MidiFile::writeEvent(const MidiEvent& event)
 //   writeTrack
 //---------------------------------------------------------
 
-bool MidiFile::writeTrack(const MidiTrack &t)
+void MidiTrackEncoder::writeTrack(const MidiTrack& t)
       {
       write("MTrk", 4);
-      qint64 lenpos = fp->pos();
+      const int lenpos = buf.size();
       writeLong(0);                 // dummy len
 
       status   = -1;
       int tick = 0;
-      for (auto i : t.events()) {
+      for (const auto& i : t.events()) {
             int ntick = i.first;
             putvl(ntick - tick);    // write tick delta
             //
@@ -170,46 +241,160 @@ bool MidiFile::writeTrack(const MidiTrack &t)
 
       //---------------------------------------------------
       //    write "End Of Track" Meta
-      //    write Track Len
+      //    patch Track Len
       //
 
       putvl(1);
       put(0xff);        // Meta
       put(0x2f);        // EOT
       putvl(0);         // len 0
-      qint64 endpos = fp->pos();
-      fp->seek(lenpos);
-      writeLong(endpos-lenpos-4);   // tracklen
-      fp->seek(endpos);
-      return false;
+      const int len = buf.size() - lenpos - 4;
+      buf[lenpos]     = char(len >> 24);
+      buf[lenpos + 1] = char(len >> 16);
+      buf[lenpos + 2] = char(len >> 8);
+      buf[lenpos + 3] = char(len);
       }
 
 //---------------------------------------------------------
 //   writeStatus
 //---------------------------------------------------------
 
-void MidiFile::writeStatus(int nstat, int c)
+void MidiTrackEncoder::writeStatus(int nstat, int c)
       {
       nstat |= (c & 0xf);
       //
       //  running status; except for Sysex- and Meta Events
       //
-      if (_noRunningStatus || (((nstat & 0xf0) != 0xf0) && (nstat != status))) {
+      if (noRunningStatus || (((nstat & 0xf0) != 0xf0) && (nstat != status))) {
             status = nstat;
             put(nstat);
             }
       }
 
+//---------------------------------------------------------
+//   writeShort
+//---------------------------------------------------------
+
+void MidiTrackEncoder::writeShort(int i)
+      {
+      put(i >> 8);
+      put(i);
+      }
+
+//---------------------------------------------------------
+//   writeLong
+//---------------------------------------------------------
+
+void MidiTrackEncoder::writeLong(int i)
+      {
+      put(i >> 24);
+      put(i >> 16);
+      put(i >> 8);
+      put(i);
+      }
+
+/*---------------------------------------------------------
+ *    putvl
+ *    Write variable-length number (7 bits per byte, MSB first)
+ *---------------------------------------------------------*/
+
+void MidiTrackEncoder::putvl(unsigned val)
+      {
+      unsigned long buf1 = val & 0x7f;
+      while ((val >>= 7) > 0) {
+            buf1 <<= 8;
+            buf1 |= 0x80;
+            buf1 += (val & 0x7f);
+            }
+      for (;;) {
+            put(buf1);
+            if (buf1 & 0x80)
+                  buf1 >>= 8;
+            else
+                  break;
+            }
+      }
+
+//---------------------------------------------------------
+//   MidiTrackDecoder
+//    parses one "MTrk" chunk from a byte span of the
+//    file buffer; keeps its own running status so that
+//    several tracks can be decoded at the same time
+//---------------------------------------------------------
+
+class MidiTrackDecoder {
+      const uchar* p;
+      const uchar* end;
+      int status;                ///< running status
+      int sstatus;               ///< running status (not reset after meta or sysex events)
+      int click;                 ///< current tick position in track
+
+      uchar get();
+      void read(uchar* dst, int len);
+      int getvl();
+      bool readEvent(MidiEvent*);
+
+   public:
+      MidiTrackDecoder(const uchar* b, const uchar* e)
+         : p(b), end(e), status(-1), sstatus(-1), click(0) {}
+      bool decode(std::vector<std::pair<int, MidiEvent>>* events);
+      };
+
+//---------------------------------------------------------
+//   MidiTrackChunk
+//    location of one track in the file buffer and the
+//    result of decoding it
+//---------------------------------------------------------
+
+struct MidiTrackChunk {
+      const uchar* begin;
+      const uchar* end;
+      std::vector<std::pair<int, MidiEvent>> events;
+      bool error = false;
+      QString exception;
+      };
+
+//---------------------------------------------------------
+//   readShort
+//   readLong
+//    big endian values from the file buffer
+//---------------------------------------------------------
+
+static int readShort(const uchar*& p, const uchar* end)
+      {
+      if (end - p < 2)
+            throw(QString("bad midifile: unexpected EOF"));
+      int val = (p[0] << 8) | p[1];
+      p += 2;
+      return val;
+      }
+
+static int readLong(const uchar*& p, const uchar* end)
+      {
+      if (end - p < 4)
+            throw(QString("bad midifile: unexpected EOF"));
+      int val = int((uint(p[0]) << 24) | (uint(p[1]) << 16) | (uint(p[2]) << 8) | uint(p[3]));
+      p += 4;
+      return val;
+      }
+
 //---------------------------------------------------------
 //   readMidi
 //    return false on error
 //---------------------------------------------------------
 
 bool MidiFile::read(QIODevice* in)
-     {
+      {
       fp = in;
       _tracks.clear();
-      curPos    = 0;
+
+      //
+      // read the whole file at once; all parsing is done
+      // on the memory buffer
+      //
+      const QByteArray buffer = in->readAll();
+      const uchar* p   = reinterpret_cast<const uchar*>(buffer.constData());
+      const uchar* end = p + buffer.size();
 
       // === Read header_chunk = "MThd" + <header_length> + <format> + <n> + <division>
       //
@@ -234,18 +419,18 @@ bool MidiFile::read(QIODevice* in)
       //    the units per beat. For example, +96 would mean 96 ticks per beat.
       //    If the value is negative, delta times are in SMPTE compatible units.
 
-      char tmp[4];
-
-      read(tmp, 4);
-      int len = readLong();
-      if (memcmp(tmp, "MThd", 4) || len < 6)
+      if (end - p < 4 || memcmp(p, "MThd", 4))
+            throw(QString("bad midifile: MThd expected"));
+      p += 4;
+      int len = readLong(p, end);
+      if (len < 6)
             throw(QString("bad midifile: MThd expected"));
 
       if (len > 6)
             throw(QString("unsupported MIDI header data size: %1 instead of 6").arg(len));
 
-      _format     = readShort();
-      int ntracks = readShort();
+      _format     = readShort(p, end);
+      int ntracks = readShort(p, end);
 
       // ================ Read MIDI division =================
       //
@@ -258,10 +443,10 @@ bool MidiFile::read(QIODevice* in)
       //  |       | 1 |  -frames/second   |   ticks/frame   |
       //  +-------+---+-------------------+-----------------+
 
-      char firstByte;
-      fp->getChar(&firstByte);
-      char secondByte;
-      fp->getChar(&secondByte);
+      if (end - p < 2)
+            throw(QString("bad midifile: unexpected EOF"));
+      const char firstByte  = char(*p++);
+      const char secondByte = char(*p++);
       const char topBit = (firstByte & 0x80) >> 7;
 
       if (topBit == 0) {            // ticks per beat
@@ -282,172 +467,107 @@ bool MidiFile::read(QIODevice* in)
 
       switch (_format) {
             case 0:
-                  if (readTrack())
-                        return false;
+                  ntracks = 1;
                   break;
             case 1:
-                  for (int i = 0; i < ntracks; i++) {
-                        if (readTrack())
-                              return false;
-                        }
                   break;
             default:
                   throw(QString("midi file format %1 not implemented").arg(_format));
+            }
+
+      //
+      // locate all track chunks first, then decode them
+      // independently of each other
+      //
+      std::vector<MidiTrackChunk> chunks(ntracks);
+      for (MidiTrackChunk& chunk : chunks) {
+            if (end - p < 4 || memcmp(p, "MTrk", 4))
+                  throw(QString("bad midifile: MTrk expected"));
+            p += 4;
+            int tlen = readLong(p, end);
+            if (tlen < 0 || tlen > end - p) {
+                  qWarning("bad track len: %d, only %lld bytes left", tlen, (long long)(end - p));
+                  tlen = int(end - p);
+                  }
+            chunk.begin = p;
+            chunk.end   = p + tlen;
+            p          += tlen;
+            }
 
-                  // Prevent "unreachable code" warning 
-                  // return false;
+      auto decodeChunk = [](MidiTrackChunk& chunk) {
+            try {
+                  MidiTrackDecoder decoder(chunk.begin, chunk.end);
+                  chunk.error = decoder.decode(&chunk.events);
+                  }
+            catch (QString error) {
+                  chunk.exception = error;
+                  }
+            };
+      if (chunks.size() > 1)
+            QtConcurrent::blockingMap(chunks, decodeChunk);
+      else if (!chunks.empty())
+            decodeChunk(chunks.front());
+
+      for (MidiTrackChunk& chunk : chunks) {
+            if (!chunk.exception.isEmpty())
+                  throw(chunk.exception);
+            _tracks.push_back(MidiTrack());
+            MidiTrack& track = _tracks.back();
+            track.setOutPort(0);
+            track.setOutChannel(-1);
+            std::multimap<int, MidiEvent>& el = track.events();
+            for (const auto& e : chunk.events)
+                  el.emplace_hint(el.end(), e);      // events are sorted by tick already
+            if (chunk.error)
+                  return false;
             }
       return true;
       }
 
 //---------------------------------------------------------
-//   readTrack
+//   decode
 //    return true on error
 //---------------------------------------------------------
 
-bool MidiFile::readTrack()
+bool MidiTrackDecoder::decode(std::vector<std::pair<int, MidiEvent>>* events)
       {
-      char tmp[4];
-      read(tmp, 4);
-      if (memcmp(tmp, "MTrk", 4))
-            throw(QString("bad midifile: MTrk expected"));
-      int len       = readLong();       // len
-      qint64 endPos = curPos + len;
-      status        = -1;
-      sstatus       = -1;  // running status, will not be reset on meta or sysex
-      click         =  0;
-      _tracks.push_back(MidiTrack());
-
-      int port = 0;
-      _tracks.back().setOutPort(port);
-      _tracks.back().setOutChannel(-1);
-
-      for (;;) {
+      // roughly three bytes per channel event
+      events->reserve((end - p) / 3);
+      while (p < end) {
             MidiEvent event;
             if (!readEvent(&event))
                   return true;
 
             // check for end of track:
-            if ((event.type() == ME_META) && (event.metaType() == META_EOT))
-                  break;
-            _tracks.back().insert(click, event);
-            }
-      if (curPos != endPos) {
-            qWarning("bad track len: %lld != %lld, %lld bytes too much\n", endPos, curPos, endPos - curPos);
-            if (curPos < endPos) {
-                  qWarning("  skip %lld\n", endPos-curPos);
-                  skip(endPos - curPos);
+            if ((event.type() == ME_META) && (event.metaType() == META_EOT)) {
+                  if (p != end)
+                        qWarning("bad track len: %lld bytes too much\n", (long long)(end - p));
+                  return false;
                   }
+            events->emplace_back(click, event);
             }
+      qWarning("track without end of track event");
       return false;
       }
 
-/*---------------------------------------------------------
- *    read
- *    return false on error
- *---------------------------------------------------------*/
-
-void MidiFile::read(void* p, qint64 len)
-      {
-      curPos += len;
-      qint64 rv = fp->read((char*)p, len);
-      if (rv != len)
-            throw(QString("bad midifile: unexpected EOF"));
-      }
-
-//---------------------------------------------------------
-//   write
-//---------------------------------------------------------
-
-bool MidiFile::write(const void* p, qint64 len)
-      {
-      qint64 rv = fp->write((char*)p, len);
-      if (rv == len)
-            return false;
-      qDebug("write midifile failed: %s", fp->errorString().toLatin1().data());
-      return true;
-      }
-
 //---------------------------------------------------------
-//   readShort
+//   get
+//   read
 //---------------------------------------------------------
 
-int MidiFile::readShort()
+uchar MidiTrackDecoder::get()
       {
-      char c;
-      int val = 0;
-      for (int i = 0; i < 2; ++i) {
-            fp->getChar(&c);
-            val <<= 8;
-            val += (c & 0xff);
-            }
-      return val;
-      }
-
-//---------------------------------------------------------
-//   writeShort
-//---------------------------------------------------------
-
-void MidiFile::writeShort(int i)
-      {
-      fp->putChar(i >> 8);
-      fp->putChar(i);
-      }
-
-//---------------------------------------------------------
-//   readLong
-//   writeLong
-//---------------------------------------------------------
-
-int MidiFile::readLong()
-      {
-      char c;
-      int val = 0;
-      for (int i = 0; i < 4; ++i) {
-            fp->getChar(&c);
-            val <<= 8;
-            val += (c & 0xff);
-            }
-      return val;
+      if (p >= end)
+            throw(QString("bad midifile: unexpected EOF"));
+      return *p++;
       }
 
-//---------------------------------------------------------
-//   writeLong
-//---------------------------------------------------------
-
-void MidiFile::writeLong(int i)
+void MidiTrackDecoder::read(uchar* dst, int len)
       {
-      fp->putChar(i >> 24);
-      fp->putChar(i >> 16);
-      fp->putChar(i >> 8);
-      fp->putChar(i);
-      }
-
-/*---------------------------------------------------------
- *    skip
- *    This is meant for skipping a few bytes in a
- *    file or fifo.
- *---------------------------------------------------------*/
-
-void MidiFile::skip(qint64 len)
-      {
-      // Note: if MS is updated to use Qt 5.10, this can be implemented with QIODevice::skip(), which should be more efficient
-      //       as bytes do not need to be moved around.
-      if (len <= 0)
-            return;
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-      char tmp[len];
-      read(tmp, len);
-#else
-      const int tmp_size = 256;  // Size of fixed-length temporary buffer. MSVC does not support VLA.
-      char tmp[tmp_size];
-      while(len > tmp_size) {
-            read(tmp, len);
-            len -= tmp_size;
-            }
-      // Now len is <= tmp_size, last read fits in the buffer.
-      read(tmp, tmp_size);
-#endif
+      if (len < 0 || len > end - p)
+            throw(QString("bad midifile: unexpected EOF"));
+      memcpy(dst, p, len);
+      p += len;
       }
 
 /*---------------------------------------------------------
@@ -455,12 +575,11 @@ void MidiFile::skip(qint64 len)
  *    Read variable-length number (7 bits per byte, MSB first)
  *---------------------------------------------------------*/
 
-int MidiFile::getvl()
+int MidiTrackDecoder::getvl()
       {
       int l = 0;
-      for (int i = 0; i < 16; i++) {
-            uchar c;
-            read(&c, 1);
+      for (int i = 0; i < 4; i++) {
+            uchar c = get();
             l += (c & 0x7f);
             if (!(c & 0x80)) {
                   return l;
@@ -470,28 +589,6 @@ int MidiFile::getvl()
       return -1;
       }
 
-/*---------------------------------------------------------
- *    putvl
- *    Write variable-length number (7 bits per byte, MSB first)
- *---------------------------------------------------------*/
-
-void MidiFile::putvl(unsigned val)
-      {
-      unsigned long buf = val & 0x7f;
-      while ((val >>= 7) > 0) {
-            buf <<= 8;
-            buf |= 0x80;
-            buf += (val & 0x7f);
-            }
-      for (;;) {
-            put(buf);
-            if (buf & 0x80)
-                  buf >>= 8;
-            else
-                  break;
-            }
-      }
-
 //---------------------------------------------------------
 //   MidiTrack
 //---------------------------------------------------------
@@ -521,7 +618,7 @@ void MidiTrack::insert(int tick, const MidiEvent& event)
 //    return true on success
 //---------------------------------------------------------
 
-bool MidiFile::readEvent(MidiEvent* event)
+bool MidiTrackDecoder::readEvent(MidiEvent* event)
       {
       uchar me, a, b;
 
@@ -532,7 +629,7 @@ bool MidiFile::readEvent(MidiEvent* event)
             }
       click += nclick;
       for (;;) {
-            read(&me, 1);
+            me = get();
             if (me >= 0xf1 && me <= 0xfe && me != 0xf7) {
                   qDebug("Midi: Unknown Message 0x%02x", me & 0xff);
                   }
@@ -550,11 +647,13 @@ bool MidiFile::readEvent(MidiEvent* event)
                   qDebug("readEvent: error 3");
                   return false;
                   }
+            if (len > end - p)
+                  throw(QString("bad midifile: unexpected EOF"));
             data    = new unsigned char[len+1];
             dataLen = len;
             read(data, len);
             data[dataLen] = 0;    // always terminate with zero
-            if (data[len-1] != 0xf7) {
+            if (len == 0 || data[len-1] != 0xf7) {
                   qDebug("SYSEX does not end with 0xf7!");
                   // more to come?
                   }
@@ -568,13 +667,14 @@ bool MidiFile::readEvent(MidiEvent* event)
 
       if (me == ME_META) {
             status = -1;                  // no running status
-            uchar type;
-            read(&type, 1);
+            uchar type = get();
             dataLen = getvl();                // read len
             if (dataLen == -1) {
                   qDebug("readEvent: error 6");
                   return false;
                   }
+            if (dataLen > end - p)
+                  throw(QString("bad midifile: unexpected EOF"));
             data = new unsigned char[dataLen + 1];
             if (dataLen)
                   read(data, dataLen);
@@ -590,7 +690,7 @@ bool MidiFile::readEvent(MidiEvent* event)
       if (me & 0x80) {                     // status byte
             status   = me;
             sstatus  = status;
-            read(&a, 1);
+            a        = get();
             }
       else {
             if (status == -1) {
@@ -611,7 +711,7 @@ bool MidiFile::readEvent(MidiEvent* event)
             case ME_POLYAFTER:
             case ME_CONTROLLER:        // controller
             case ME_PITCHBEND:        // pitch bend
-                  read(&b, 1);
+                  b = get();
                   break;
             }
       event->setType(status & 0xf0);
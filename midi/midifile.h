@@ -76,34 +76,9 @@ class MidiFile {
       bool _noRunningStatus;     ///< do not use running status on output
       MidiType _midiType;
 
-      // values used during read()
-      int status;                ///< running status
-      int sstatus;               ///< running status (not reset after meta or sysex events)
-      int click;                 ///< current tick position in file
-      qint64 curPos;             ///< current file byte position
-
-      void writeEvent(const MidiEvent& event);
-
    protected:
       // write
-      bool write(const void*, qint64);
-      void writeShort(int);
-      void writeLong(int);
-      bool writeTrack(const MidiTrack &);
-      void putvl(unsigned);
-      void put(unsigned char c) { write(&c, 1); }
-      void writeStatus(int type, int channel);
-
-      // read
-      void read(void*, qint64);
-      int getvl();
-      int readShort();
-      int readLong();
-      bool readEvent(MidiEvent*);
-      bool readTrack();
-      void skip(qint64);
-
-      void resetRunningStatus() { status = -1; }
+      static QByteArray encodeTrack(const MidiTrack&, bool noRunningStatus);
 
    public:
       MidiFile();
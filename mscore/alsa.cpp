@@ -759,15 +759,6 @@ Transport AlsaAudio::getState()
       return state;
       }
 
-//---------------------------------------------------------
-//   midiRead
-//---------------------------------------------------------
-
-void AlsaAudio::midiRead()
-      {
-      midiDriver->read();
-      }
-
 //---------------------------------------------------------
 //   updateOutPortCount
 //   Add/remove ALSA MIDI Out ports
@@ -134,7 +134,6 @@ class AlsaAudio : public Driver {
       void alsaLoop();
       void write(int n, void* l);
 
-      virtual void midiRead();
       virtual void updateOutPortCount(int maxport);
       };
 
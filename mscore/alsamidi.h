@@ -24,6 +24,8 @@
 #ifndef __ALSAMIDI_H__
 #define __ALSAMIDI_H__
 
+#include <vector>
+
 #include "mididriver.h"
 
 namespace Ms {
@@ -39,15 +41,19 @@ struct PortName {
 
 class AlsaMidiDriver : public MidiDriver {
       snd_seq_t* alsaSeq;
+      std::vector<struct pollfd> inputFds;
 
       bool putEvent(snd_seq_event_t* event);
       QList<PortName> outputPorts();
       QList<PortName> inputPorts();
       bool connect(Port src, Port dst);
 
+   protected:
+      virtual bool waitForInput(int msec);
+
    public:
       AlsaMidiDriver(Seq* s);
-      virtual ~AlsaMidiDriver() {}
+      virtual ~AlsaMidiDriver() { stopInputThread(); }
       virtual bool init();
       virtual Port registerOutPort(const QString& name);
       virtual Port registerInPort(const QString& name);
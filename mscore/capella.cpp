@@ -404,13 +404,26 @@ Fraction TupletFractionCap(int tupletCount, bool tuplettrp, bool tupletprol)
       return Fraction(nn, dd);
       }
 
+//---------------------------------------------------------
+//   isGraceChordObj
+//---------------------------------------------------------
+
+static bool isGraceChordObj(const NoteObj* nobj)
+      {
+      if (nobj->type() != CapellaNoteObjectType::CHORD)
+            return false;
+      const ChordObj* cho = static_cast<const ChordObj*>(nobj);
+      return !(cho->invisible) && cho->ticks().isZero();
+      }
+
 //---------------------------------------------------------
 //   findChordRests -- find begin and end ChordRest for BasicDrawObj o
+//   which is attached to objects[noIdx]
 //   return true on success (both begin and end found)
 //---------------------------------------------------------
 
 static bool findChordRests(BasicDrawObj const* const o, Score* score, const int track, const Fraction& tick,
-                           ChordRest*& cr1, ChordRest*& cr2, NoteObj* no, QList<NoteObj*> objects)
+                           ChordRest*& cr1, ChordRest*& cr2, const QList<NoteObj*>& objects, int noIdx)
       {
       cr1 = 0;                         // ChordRest where BasicDrawObj o begins
       cr2 = 0;                         // ChordRest where BasicDrawObj o ends
@@ -421,7 +434,20 @@ static bool findChordRests(BasicDrawObj const* const o, Score* score, const int
       int graceNumber1 = 0;
       bool foundcr1 = false;
       Fraction tick2 = tick;
-      foreach(NoteObj* nobj, objects) {
+      NoteObj* no = objects[noIdx];
+
+      // objects before "no" only matter for counting the grace notes
+      // preceding it: start at the last rest or regular chord
+      int startIdx = noIdx;
+      while (startIdx > 0) {
+            const NoteObj* prev = objects[startIdx - 1];
+            if (prev->type() == CapellaNoteObjectType::REST
+               || (prev->type() == CapellaNoteObjectType::CHORD && !isGraceChordObj(prev)))
+                  break;
+            --startIdx;
+            }
+      for (int i = startIdx; i < objects.size(); ++i) {
+            NoteObj* nobj = objects[i];
             BasicDurationalObj* d = 0;
             if (nobj->type() == CapellaNoteObjectType::REST) {
                   d = static_cast<BasicDurationalObj*>(static_cast<RestObj*>(nobj));
@@ -430,7 +456,7 @@ static bool findChordRests(BasicDrawObj const* const o, Score* score, const int
             else if (nobj->type() == CapellaNoteObjectType::CHORD) {
                   ChordObj* cho = static_cast<ChordObj*>(nobj);
                   d = static_cast<BasicDurationalObj*>(cho);
-                  if (!(cho->invisible) && (cho->ticks().isZero())) // grace note
+                  if (isGraceChordObj(cho))
                         ++graceNumber;
                   else
                         graceNumber = 0;
@@ -918,7 +944,8 @@ static Fraction readCapVoice(Score* score, CapVoice* cvoice, int staffIdx, const
       // pass II
       //
       tick = startTick;
-      foreach(NoteObj* no, cvoice->objects) {
+      for (int noIdx = 0; noIdx < cvoice->objects.size(); ++noIdx) {
+            NoteObj* no = cvoice->objects[noIdx];
             BasicDurationalObj* d = 0;
             if (no->type() == CapellaNoteObjectType::REST)
                   d = static_cast<BasicDurationalObj*>(static_cast<RestObj*>(no));
@@ -940,7 +967,7 @@ static Fraction readCapVoice(Score* score, CapVoice* cvoice, int staffIdx, const
                               //        so->nDotDist, so->nDotWidth, so->nRefNote, so->nNotes);
                               ChordRest* cr1 = 0; // ChordRest where slur begins
                               ChordRest* cr2 = 0; // ChordRest where slur ends
-                              bool res = findChordRests(o, score, track, tick, cr1, cr2, no, cvoice->objects);
+                              bool res = findChordRests(o, score, track, tick, cr1, cr2, cvoice->objects, noIdx);
 
                               if (res) {
                                     if (cr1 == cr2)
@@ -986,7 +1013,7 @@ static Fraction readCapVoice(Score* score, CapVoice* cvoice, int staffIdx, const
                               VoltaObj* vo = static_cast<VoltaObj*>(o);
                               ChordRest* cr1 = 0; // ChordRest where volta begins
                               ChordRest* cr2 = 0; // ChordRest where volta ends
-                              bool res = findChordRests(o, score, track, tick, cr1, cr2, no, cvoice->objects);
+                              bool res = findChordRests(o, score, track, tick, cr1, cr2, cvoice->objects, noIdx);
 
                               if (res) {
                                     Volta* volta = new Volta(score);
@@ -1010,7 +1037,7 @@ static Fraction readCapVoice(Score* score, CapVoice* cvoice, int staffIdx, const
                               TrillObj* tro = static_cast<TrillObj*>(o);
                               ChordRest* cr1 = 0; // ChordRest where trill line begins
                               ChordRest* cr2 = 0; // ChordRest where trill line ends
-                              bool res = findChordRests(o, score, track, tick, cr1, cr2, no, cvoice->objects);
+                              bool res = findChordRests(o, score, track, tick, cr1, cr2, cvoice->objects, noIdx);
                               if (res) {
                                     if (cr1 == cr2)
                                           qDebug("first and second anchor for trill line identical (tick %d track %d first %p second %p)",
@@ -1033,7 +1060,7 @@ static Fraction readCapVoice(Score* score, CapVoice* cvoice, int staffIdx, const
                               WedgeObj* wdgo = static_cast<WedgeObj*>(o);
                               ChordRest* cr1 = 0; // ChordRest where hairpin begins
                               ChordRest* cr2 = 0; // ChordRest where hairpin ends
-                              bool res = findChordRests(o, score, track, tick, cr1, cr2, no, cvoice->objects);
+                              bool res = findChordRests(o, score, track, tick, cr1, cr2, cvoice->objects, noIdx);
                               if (res) {
                                     if (cr1 == cr2)
                                           qDebug("first and second anchor for hairpin identical (tick %d track %d first %p second %p)",
@@ -2699,6 +2726,8 @@ Score::FileError importCapella(MasterScore* score, const QString& name)
       if (!fp.open(QIODevice::ReadOnly))
             return Score::FileError::FILE_OPEN_ERROR;
 
+      QElapsedTimer timer;
+      timer.start();
       Capella cf;
       try {
             cf.read(&fp);
@@ -2715,7 +2744,11 @@ Score::FileError importCapella(MasterScore* score, const QString& name)
             return Score::FileError::FILE_NO_ERROR;
             }
       fp.close();
+      if (MScore::debugMode)
+            qDebug("importCapella: parse %lld ms", timer.restart());
       convertCapella(score, &cf, false);
+      if (MScore::debugMode)
+            qDebug("importCapella: convert %lld ms", timer.elapsed());
       return Score::FileError::FILE_NO_ERROR;
       }
 }
@@ -1191,6 +1191,8 @@ Score::FileError importCapXml(MasterScore* score, const QString& name)
             return Score::FileError::FILE_NOT_FOUND;
             }
 
+      QElapsedTimer timer;
+      timer.start();
       QByteArray dbuf = uz.fileData("score.xml");
       XmlReader e(dbuf);
       e.setDocName(name);
@@ -1205,8 +1207,12 @@ Score::FileError importCapXml(MasterScore* score, const QString& name)
             else
                   e.unknown();
             }
+      if (MScore::debugMode)
+            qDebug("importCapXml: parse %lld ms", timer.restart());
 
       convertCapella(score, &cf, true);
+      if (MScore::debugMode)
+            qDebug("importCapXml: convert %lld ms", timer.elapsed());
       return Score::FileError::FILE_NO_ERROR;
       }
 }
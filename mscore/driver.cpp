@@ -20,6 +20,8 @@
 #include "config.h"
 #include "preferences.h"
 #include "driver.h"
+#include "nullaudio.h"
+#include "seq.h"
 
 #ifdef USE_JACK
 #include "jackaudio.h"
@@ -44,12 +46,23 @@ bool alsaIsUsed = false, jackIsUsed = false, portAudioIsUsed = false, pulseAudio
 
 //---------------------------------------------------------
 //   driverFactory
-//    driver can be: jack alsa pulse portaudio
+//    driver can be: jack alsa pulse portaudio null
+//    the null driver takes options, see NullAudio::setOptions()
 //---------------------------------------------------------
 
 Driver* driverFactory(Seq* seq, QString driverName)
       {
       Driver* driver = 0;
+      if (driverName.section(',', 0, 0).toLower() == "null") {
+            NullAudio* nullAudio = new NullAudio(seq);
+            nullAudio->setSource([seq](unsigned frames, float* buffer) { seq->process(frames, buffer); });
+            if (!nullAudio->setOptions(driverName.section(',', 1)) || !nullAudio->init()) {
+                  qDebug("init null audio driver failed");
+                  delete nullAudio;
+                  return 0;
+                  }
+            return nullAudio;
+            }
 #if 1 // DEBUG: force "no audio"
       bool useJackFlag       = (preferences.getBool(PREF_IO_JACK_USEJACKAUDIO) || preferences.getBool(PREF_IO_JACK_USEJACKMIDI));
       bool useAlsaFlag       = preferences.getBool(PREF_IO_ALSA_USEALSAAUDIO);
@@ -47,7 +47,6 @@ class Driver {
       virtual void seekTransport(int) {}
       virtual int sampleRate() const = 0;
       virtual void putEvent(const NPlayEvent&, unsigned /*framePos*/) {}
-      virtual void midiRead() {}
       virtual void handleTimeSigTempoChanged() {}
       virtual void checkTransportSeek(int, int, bool) {}
       virtual int bufferSize() {return 0;}
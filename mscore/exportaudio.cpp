@@ -113,39 +113,26 @@ bool MuseScore::saveAudio(Score* score, QIODevice *device, std::function<bool(fl
           int playTime = 0;
 
           for (;;) {
-                unsigned frames = FRAMES;
                 //
                 // collect events for one segment
                 //
                 float max = 0.0;
                 memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                int endTime = playTime + frames;
-                float* p = buffer;
+                int endTime = playTime + FRAMES;
                 for (; playPos != events.cend(); ++playPos) {
                       int f = score->utick2utime(playPos->first) * MScore::sampleRate;
                       if (f >= endTime)
                             break;
-                      int n = f - playTime;
-                      if (n) {
-                            synth->process(n, p);
-                            p += 2 * n;
-                            }
-
-                      playTime  += n;
-                      frames    -= n;
                       const NPlayEvent& e = playPos->second;
                       if (e.isChannelEvent()) {
                             int channelIdx = e.channel();
                             const Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation();
                             if (!c->mute()) {
-                                  synth->play(e, synth->index(c->synti()));
+                                  synth->schedule(e, synth->index(c->synti()), qMax(f - playTime, 0));
                                   }
                             }
                       }
-                if (frames) {
-                      synth->process(frames, p);
-                      playTime += frames;
-                      }
+                synth->process(FRAMES, buffer);
                 if (pass == 1) {
                       for (unsigned i = 0; i < FRAMES * 2; ++i) {
                             max = qMax(max, qAbs(buffer[i]));
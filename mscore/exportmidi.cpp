@@ -230,6 +230,23 @@ bool ExportMidi::write(QIODevice* device, bool midiExpandRepeats, bool exportRPN
       pauseMap.calculate(cs);
       writeHeader();
 
+      //
+      // distribute rendered events to their tracks in one pass
+      // instead of scanning the whole event map for every
+      // staff and channel
+      //
+      const int nstaves = cs->nstaves();
+      std::vector<std::vector<EventMap::const_iterator>> staffEvents(nstaves);
+      for (auto i = events.cbegin(); i != events.cend(); ++i) {
+            const NPlayEvent& event = i->second;
+            const int origStaff     = event.getOriginatingStaff();
+            const int restrikeStaff = (event.discard() && event.velo() > 0) ? event.discard() - 1 : -1;
+            if (restrikeStaff >= 0 && restrikeStaff < nstaves && restrikeStaff != origStaff)
+                  staffEvents[restrikeStaff].push_back(i);
+            if (origStaff >= 0 && origStaff < nstaves)
+                  staffEvents[origStaff].push_back(i);
+            }
+
       int staffIdx = 0;
       for (auto &track: tracks) {
             Staff* staff = cs->staff(staffIdx);
@@ -290,7 +307,7 @@ bool ExportMidi::write(QIODevice* device, bool midiExpandRepeats, bool exportRPN
                               track.insert(0, ev);
                               }
 
-                        for (auto i = events.begin(); i != events.end(); ++i) {
+                        for (auto i : staffEvents[staffIdx]) {
                               const NPlayEvent& event = i->second;
 
                               if (event.discard() == staffIdx + 1 && event.velo() > 0)
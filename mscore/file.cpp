@@ -2150,12 +2150,18 @@ bool MuseScore::savePdf(QList<Score*> cs_, const QString& saveName)
 
       bool firstPage = true;
       for (Score* s : cs_) {
+            //
+            // scores and parts are kept laid out after every command,
+            // so only lay out again if the page layout is missing;
+            // a full layout of every part dominates the export time
+            //
             LayoutMode layoutMode = s->layoutMode();
             if (layoutMode != LayoutMode::PAGE) {
                   s->setLayoutMode(LayoutMode::PAGE);
-            //      s->doLayout();
+                  s->doLayout();
                   }
-            s->doLayout();
+            else if (s->pages().isEmpty())
+                  s->doLayout();
 
             // done in Score::print() also, but do it here as well to be safe
             s->setPrinting(true);
@@ -95,6 +95,7 @@ private:
       int quarter_;
       OVE::OveSong* ove_;
       QList<TimeTick> tts_;
+      QVector<int> measureTicks_;   // start tick of every measure
       };
 
 int getMeasureTick(int quarter, int num, int den){
@@ -117,6 +118,8 @@ void MeasureToTick::build(OVE::OveSong* ove, int quarter){
       quarter_ = quarter;
       ove_ = ove;
       tts_.clear();
+      measureTicks_.clear();
+      measureTicks_.reserve(measureCount);
 
       for(i=0; i<measureCount; ++i)	{
             OVE::Measure* measure = ove_->getMeasure(i);
@@ -147,12 +150,17 @@ void MeasureToTick::build(OVE::OveSong* ove, int quarter){
                   tts_.push_back(tt);
                   }
 
+            measureTicks_.push_back(currentTick);
             currentTick += getMeasureTick(quarter_, tt.numerator_, tt.denominator_);
             }
       }
 
 int MeasureToTick::getTick(int measure, int tick_pos){
-      TimeTick tt;
+      // called for every converted element, so look up measures
+      // in the table built by build()
+      if( measure >= 0 && measure < measureTicks_.size() ) {
+            return measureTicks_[measure] + tick_pos;
+            }
 
       for(int i=0; i<tts_.size(); ++i) {
             if( measure >= tts_[i].measure_ && ( i==tts_.size()-1 || measure < tts_[i+1].measure_ ) ) {
@@ -234,6 +242,9 @@ OveToMScore::~OveToMScore() {
       }
 
 void OveToMScore::convert(OVE::OveSong* ove, Score* score) {
+      QElapsedTimer timer;
+      timer.start();
+
       ove_ = ove;
       score_ = score;
       mtt_->build(ove_, ove_->getQuarter());
@@ -243,6 +254,8 @@ void OveToMScore::convert(OVE::OveSong* ove, Score* score) {
       convertGroups();
       convertSignatures();
       //convertLineBreak();
+      if (MScore::debugMode)
+            qDebug("importOve: structure %lld ms", timer.restart());
 
       int staffCount = 0;
       for(int i=0; i<ove_->getPartCount(); ++i ){
@@ -259,6 +272,8 @@ void OveToMScore::convert(OVE::OveSong* ove, Score* score) {
             }
 
       convertMeasures();
+      if (MScore::debugMode)
+            qDebug("importOve: measures %lld ms", timer.restart());
 
       // convert elements by ove track sequence
       staffCount = 0;
@@ -273,6 +288,8 @@ void OveToMScore::convert(OVE::OveSong* ove, Score* score) {
 
             staffCount += partStaffCount;
             }
+      if (MScore::debugMode)
+            qDebug("importOve: track elements %lld ms", timer.elapsed());
 
       clearUp();
       }
@@ -2408,11 +2425,15 @@ Score::FileError importOve(MasterScore* score, const QString& name) {
 
       oveFile.close();
 
+      QElapsedTimer timer;
+      timer.start();
       oveSong.setTextCodecName(preferences.getString(PREF_IMPORT_OVERTURE_CHARSET));
       oveLoader->setOve(&oveSong);
       oveLoader->setFileStream((unsigned char*) buffer.data(), buffer.size());
       bool result = oveLoader->load();
       oveLoader->release();
+      if (MScore::debugMode)
+            qDebug("importOve: parse %lld ms", timer.elapsed());
 
       if(result){
             OveToMScore otm;
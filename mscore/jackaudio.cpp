@@ -391,12 +391,12 @@ int JackAudio::processAudio(jack_nframes_t frames, void* p)
                               if (type == ME_NOTEON || type == ME_NOTEOFF) {
                                     e.setPitch(event.buffer[1]);
                                     e.setVelo(event.buffer[2]);
-                                    audio->seq->eventToGui(e);
+                                    audio->seq->midiInputEvent(e);
                                     }
                               else if (type == ME_CONTROLLER) {
                                     e.setController(event.buffer[1]);
                                     e.setValue(event.buffer[2]);
-                                    audio->seq->eventToGui(e);
+                                    audio->seq->midiInputEvent(e);
                                     }
                               }
                         }
@@ -654,15 +654,6 @@ void JackAudio::putEvent(const NPlayEvent& e, unsigned framePos)
             }
       }
 
-//---------------------------------------------------------
-//   midiRead
-//---------------------------------------------------------
-
-void JackAudio::midiRead()
-      {
-//      midiDriver->read();
-      }
-
 //---------------------------------------------------------
 //   handleTimeSigTempoChanged
 //   Called after tempo or time signature
@@ -77,7 +77,6 @@ class JackAudio : public Driver {
       virtual void seekTransport(int);
       virtual int sampleRate() const    { return jack_get_sample_rate(client); }
       virtual void putEvent(const NPlayEvent&, unsigned framePos);
-      virtual void midiRead();
 
       virtual void registerPort(const QString& name, bool input, bool midi);
       virtual void unregisterPort(jack_port_t*);
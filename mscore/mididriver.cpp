@@ -94,6 +94,45 @@ bool Port::operator<(const Port& p) const
             }
       return false;
       }
+
+//---------------------------------------------------------
+//   startInputThread
+//    read midi input on a thread of its own, so that notes
+//    sound at once even while the gui thread is busy
+//---------------------------------------------------------
+
+void MidiDriver::startInputThread()
+      {
+      if (inputThread.joinable())
+            return;
+      inputRunning = true;
+      inputThread  = std::thread(&MidiDriver::inputLoop, this);
+      }
+
+//---------------------------------------------------------
+//   stopInputThread
+//    must be called by the destructor of derived classes
+//---------------------------------------------------------
+
+void MidiDriver::stopInputThread()
+      {
+      if (!inputThread.joinable())
+            return;
+      inputRunning = false;
+      inputThread.join();
+      }
+
+//---------------------------------------------------------
+//   inputLoop
+//---------------------------------------------------------
+
+void MidiDriver::inputLoop()
+      {
+      while (inputRunning) {
+            if (waitForInput(50))
+                  read();
+            }
+      }
 }
 
 #ifdef USE_ALSA
@@ -165,13 +204,8 @@ bool AlsaMidiDriver::init()
       struct pollfd* pfd;
       int npfd;
       getInputPollFd(&pfd, &npfd);
-      for (int i = 0; i < npfd; ++i) {
-            int fd = pfd[i].fd;
-            if (fd != -1) {
-                  QSocketNotifier* s = new QSocketNotifier(fd, QSocketNotifier::Read,  mscore);
-                  s->connect(s, SIGNAL(activated(int)), seq, SLOT(midiInputReady()));
-                  }
-            }
+      inputFds.assign(pfd, pfd + npfd);
+      delete[] pfd;
 #if 0
       // TODO: autoconnect all output ports
       QList<PortName> ol = outputPorts();
@@ -189,6 +223,7 @@ bool AlsaMidiDriver::init()
                   qDebug("connect to midi input <%s>", qPrintable(pn.name));
             connect(pn.port, midiInPort);
             }
+      startInputThread();
       return true;
       }
 
@@ -369,8 +404,21 @@ void AlsaMidiDriver::getOutputPollFd(struct pollfd** p, int* n)
       *n = npfdo;
       }
 
+//---------------------------------------------------------
+//   waitForInput
+//    return true if there is input to read
+//---------------------------------------------------------
+
+bool AlsaMidiDriver::waitForInput(int msec)
+      {
+      if (inputFds.empty())
+            return false;
+      return poll(inputFds.data(), inputFds.size(), msec) > 0;
+      }
+
 //---------------------------------------------------------
 //   read
+//    called in the midi input thread
 //---------------------------------------------------------
 
 void AlsaMidiDriver::read()
@@ -381,7 +429,7 @@ void AlsaMidiDriver::read()
             if (rv < 0)
                   return;
 
-            if (!mscore || !mscore->midiinEnabled()) {
+            if (!seq->midiInputEnabled()) {
                   snd_seq_free_event(ev);
                   return;
                   }
@@ -389,15 +437,15 @@ void AlsaMidiDriver::read()
             if (ev->type == SND_SEQ_EVENT_NOTEON) {
                   int pitch = ev->data.note.note;
                   int velo  = ev->data.note.velocity;
-                  mscore->midiNoteReceived(ev->data.note.channel, pitch, velo);
+                  seq->midiInputEvent(NPlayEvent(ME_NOTEON, ev->data.note.channel, pitch, velo));
                   }
             else if (ev->type == SND_SEQ_EVENT_NOTEOFF) {    // "Virtual Keyboard" sends this
                   int pitch = ev->data.note.note;
-                  mscore->midiNoteReceived(ev->data.note.channel, pitch, 0);
+                  seq->midiInputEvent(NPlayEvent(ME_NOTEOFF, ev->data.note.channel, pitch, 0));
                   }
             else if (ev->type == SND_SEQ_EVENT_CONTROLLER) {
-                  mscore->midiCtrlReceived(ev->data.control.param,
-                     ev->data.control.value);
+                  seq->midiInputEvent(NPlayEvent(ME_CONTROLLER, ev->data.control.channel,
+                     ev->data.control.param, ev->data.control.value));
                   }
 
             if (midiInputTrace) {
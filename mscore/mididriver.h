@@ -28,6 +28,9 @@
 #include <poll.h>
 #endif
 
+#include <atomic>
+#include <thread>
+
 #include "config.h"
 #include "driver.h"
 
@@ -66,11 +69,20 @@ class Port {
 //---------------------------------------------------------
 
 class MidiDriver {
+      std::thread inputThread;
+      std::atomic<bool> inputRunning { false };
+
+      void inputLoop();
+
    protected:
       Port midiInPort;
       QList<Port> midiOutPorts;
       Seq* seq;
 
+      void startInputThread();
+      void stopInputThread();
+      virtual bool waitForInput(int msec) = 0;
+
    public:
       MidiDriver(Seq* s) { seq = s; }
       virtual ~MidiDriver() {}
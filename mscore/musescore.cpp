@@ -3068,7 +3068,7 @@ bool MuseScore::processMidiRemote(MidiRemoteType type, int dta, int value)
 //   midiNoteReceived
 //---------------------------------------------------------
 
-void MuseScore::midiNoteReceived(int channel, int pitch, int velo)
+void MuseScore::midiNoteReceived(int channel, int pitch, int velo, bool sounded)
       {
       static const int THRESHOLD_DRUMS = 5; // iterations required before consecutive drum notes
                                      // are not considered part of a chord
@@ -3114,11 +3114,11 @@ void MuseScore::midiNoteReceived(int channel, int pitch, int velo)
                   if (iterDrums >= THRESHOLD_DRUMS)
                         activeDrums = 0;
                   iterDrums = 0;
-                  cv->midiNoteReceived(pitch, activeDrums > 0, velo);
+                  cv->midiNoteReceived(pitch, activeDrums > 0, velo, sounded);
                   }
             else {
                   //qDebug("    midiNoteReceived %d active %d", pitch, active);
-                  cv->midiNoteReceived(pitch, active > 0, velo);
+                  cv->midiNoteReceived(pitch, active > 0, velo, sounded);
                   ++active;
                   }
             }
@@ -3131,7 +3131,7 @@ void MuseScore::midiNoteReceived(int channel, int pitch, int velo)
                   --active;
             if ((channel == 0x09) && (activeDrums > 0))
                   --activeDrums;
-            cv->midiNoteReceived(pitch, false, velo);
+            cv->midiNoteReceived(pitch, false, velo, sounded);
             }
 
       if (_pianoTools && _pianoTools->isVisible()) {
@@ -3457,18 +3457,22 @@ static bool doConvert(Score *cs, const QString& fn);
 
 static bool doConvert(Score* cs, const QJsonArray& outFiles, QString plugin)
       {
-      LayoutMode layoutMode = cs->layoutMode();
-      cs->setLayoutMode(LayoutMode::PAGE);
-      if (cs->layoutMode() != layoutMode)
-            cs->doLayout();
-
+      bool styleLoaded = false;
       if (!styleFile.isEmpty()) {
             QFile f(styleFile);
             if (f.open(QIODevice::ReadOnly)) {
                   fprintf(stderr, "\tusing style <%s>\n", qPrintable(styleFile));
                   cs->style().load(&f);
+                  styleLoaded = true;
                   }
             }
+
+      // the exporters rely on the page layout being up to date
+      LayoutMode layoutMode = cs->layoutMode();
+      cs->setLayoutMode(LayoutMode::PAGE);
+      if (cs->layoutMode() != layoutMode || styleLoaded)
+            cs->doLayout();
+
       if (!plugin.isEmpty()) {
             if (mscore->loadPlugin(plugin)) {
                   fprintf(stderr, "\tusing plugin <%s>\n", qPrintable(plugin));
@@ -6930,69 +6934,32 @@ bool MuseScore::saveMp3(Score* score, QIODevice* device, bool& wasCanceled)
             int playTime = 0.0;
 
             for (;;) {
-                  unsigned frames = FRAMES;
                   float max = 0;
                   //
                   // collect events for one segment
                   //
-                  memset(bufferL, 0, sizeof(float) * FRAMES);
-                  memset(bufferR, 0, sizeof(float) * FRAMES);
-                  double endTime = playTime + frames;
-
-                  float* l = bufferL;
-                  float* r = bufferR;
+                  float bu[FRAMES * 2];
+                  memset(bu, 0, sizeof(float) * 2 * FRAMES);
+                  double endTime = playTime + FRAMES;
 
                   for (; playPos != events.cend(); ++playPos) {
                         double f = score->utick2utime(playPos->first) * MScore::sampleRate;
                         if (f >= endTime)
                               break;
-                        int n = f - playTime;
-                        if (n) {
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-                              float bu[n * 2];
-                              memset(bu, 0, sizeof(float) * 2 * n);
-#else
-                              // MSVC does not support VLA. Replace with std::vector. If profiling determines that the
-                              //    heap allocation is slow, an optimization might be used.
-                              std::vector<float> vBu(n * 2, 0);   // Default initialized, memset() not required.
-                              float* bu = vBu.data();
-#endif
-
-                              synth->process(n, bu);
-                              float* sp = bu;
-                              for (int i = 0; i < n; ++i) {
-                                    *l++ = *sp++;
-                                    *r++ = *sp++;
-                                    }
-                              playTime  += n;
-                              frames    -= n;
-                              }
                         const NPlayEvent& e = playPos->second;
                         if (e.isChannelEvent()) {
                               int channelIdx = e.channel();
                               Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation();
                               if (!c->mute()) {
-                                    synth->play(e, synth->index(c->synti()));
+                                    synth->schedule(e, synth->index(c->synti()), qMax(int(f - playTime), 0));
                                     }
                               }
                         }
-                  if (frames) {
-#if (!defined (_MSCVER) && !defined (_MSC_VER))
-                        float bu[frames * 2];
-                        memset(bu, 0, sizeof(float) * 2 * frames);
-#else
-                        // MSVC does not support VLA. Replace with std::vector. If profiling determines that the
-                        //    heap allocation is slow, an optimization might be used.
-                        std::vector<float> vBu(frames * 2, 0);   // Default initialized, memset() not required.
-                        float* bu = vBu.data();
-#endif
-                        synth->process(frames, bu);
-                        float* sp = bu;
-                        for (unsigned i = 0; i < frames; ++i) {
-                              *l++ = *sp++;
-                              *r++ = *sp++;
-                              }
-                        playTime += frames;
+                  synth->process(FRAMES, bu);
+                  float* sp = bu;
+                  for (int i = 0; i < FRAMES; ++i) {
+                        bufferL[i] = *sp++;
+                        bufferR[i] = *sp++;
                         }
 
                   if (pass == 1) {
@@ -7212,7 +7179,7 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"L", "layout-debug"}, "Layout debug mode"));
       parser.addOption(QCommandLineOption({"s", "no-synthesizer"}, "No internal synthesizer"));
       parser.addOption(QCommandLineOption({"m", "no-midi"}, "No MIDI"));
-      parser.addOption(QCommandLineOption({"a", "use-audio"}, "Use audio driver: jack, alsa, pulse, or portaudio", "driver"));
+      parser.addOption(QCommandLineOption({"a", "use-audio"}, "Use audio driver: jack, alsa, pulse, portaudio, or null[,frames=N][,rate=N][,realtime][,seconds=N][,wav=file]", "driver"));
       parser.addOption(QCommandLineOption({"n", "new-score"}, "Start with new score"));
       parser.addOption(QCommandLineOption({"I", "dump-midi-in"}, "Dump midi input"));
       parser.addOption(QCommandLineOption({"O", "dump-midi-out"}, "Dump midi output"));
@@ -7552,6 +7519,7 @@ int main(int argc, char* av[])
             MScore::seq    = seq;
             Driver* driver = driverFactory(seq, audioDriver);
             synti          = synthesizerFactory();
+            synti->createRenderPool();
             if (driver) {
                   MScore::sampleRate = driver->sampleRate();
                   synti->setSampleRate(MScore::sampleRate);
@@ -7783,8 +7751,12 @@ bool MuseScore::exportPartsPdfsToJSON(const QString& inFilePath, const QString&
       //save score pdf
       if (!styleFile.isEmpty()) {
             QFile f(styleFile);
-            if (f.open(QIODevice::ReadOnly))
+            if (f.open(QIODevice::ReadOnly)) {
                   score->style().load(&f);
+                  // savePdf() does not lay out again
+                  score->setLayoutMode(LayoutMode::PAGE);
+                  score->doLayout();
+                  }
       }
       score->switchToPageMode();
 
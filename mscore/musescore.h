@@ -581,7 +581,7 @@ class MuseScore : public QMainWindow, public MuseScoreCore {
       void setNoteEntryState() { changeState(STATE_NOTE_ENTRY); }
       void checkForUpdatesUI();
       void checkForExtensionsUpdate();
-      void midiNoteReceived(int channel, int pitch, int velo);
+      void midiNoteReceived(int channel, int pitch, int velo, bool sounded = false);
       void midiNoteReceived(int pitch, bool ctrl, int velo);
       void instrumentChanged();
       void showMasterPalette(const QString& = 0);
@@ -0,0 +1,290 @@
+//=============================================================================
+//  MuseScore
+//  Linux Music Score Editor
+//
+//  Copyright (C) 2020 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#include "nullaudio.h"
+#include "seq.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   add
+//---------------------------------------------------------
+
+void CallbackStats::add(qint64 us, qint64 periodUs)
+      {
+      if (callbacks == 0 || us < minUs)
+            minUs = us;
+      maxUs    = qMax(maxUs, us);
+      totalUs += us;
+      ++callbacks;
+      if (us > periodUs)
+            ++xruns;
+      int bucket = 0;
+      while (bucket < BUCKETS - 1 && (qint64(2) << bucket) <= us)
+            ++bucket;
+      ++histogram[bucket];
+      }
+
+//---------------------------------------------------------
+//   toString
+//---------------------------------------------------------
+
+QString CallbackStats::toString() const
+      {
+      QString s = QString("callbacks %1, xruns %2, min %3us, avg %4us, max %5us\n")
+         .arg(callbacks).arg(xruns).arg(minUs).arg(averageUs(), 0, 'f', 1).arg(maxUs);
+      for (int i = 0; i < BUCKETS; ++i) {
+            if (histogram[i])
+                  s += QString("  < %1us: %2\n").arg(qint64(2) << i, 8).arg(histogram[i]);
+            }
+      return s;
+      }
+
+//---------------------------------------------------------
+//   NullAudio
+//---------------------------------------------------------
+
+NullAudio::NullAudio(Seq* s)
+   : Driver(s)
+      {
+      _state = Transport::STOP;
+      }
+
+NullAudio::~NullAudio()
+      {
+      stop();
+      }
+
+//---------------------------------------------------------
+//   setOptions
+//    comma separated list of
+//       frames=<n>     buffer size in frames
+//       rate=<n>       sample rate
+//       realtime       pace the callbacks like a sound card
+//       seconds=<n>    stop after that many seconds of audio
+//       wav=<file>     write output to a 32 bit float WAV file
+//    return false on error
+//---------------------------------------------------------
+
+bool NullAudio::setOptions(const QString& options)
+      {
+      qreal seconds = 0.0;
+      for (const QString& option : options.split(',', QString::SkipEmptyParts)) {
+            QString key   = option.section('=', 0, 0).trimmed().toLower();
+            QString value = option.section('=', 1).trimmed();
+            bool ok       = true;
+            if (key == "frames")
+                  _bufferSize = value.toInt(&ok);
+            else if (key == "rate")
+                  _sampleRate = value.toInt(&ok);
+            else if (key == "realtime")
+                  _realtime = true;
+            else if (key == "seconds")
+                  seconds = value.toDouble(&ok);
+            else if (key == "wav")
+                  _wavName = value;
+            else
+                  ok = false;
+            if (!ok) {
+                  qDebug("null audio: bad option <%s>", qPrintable(option));
+                  return false;
+                  }
+            }
+      _maxFrames = qint64(seconds * _sampleRate);
+      return _bufferSize > 0 && _sampleRate > 0;
+      }
+
+//---------------------------------------------------------
+//   init
+//    return false on error
+//---------------------------------------------------------
+
+bool NullAudio::init(bool /*hot*/)
+      {
+      _buffer.resize(_bufferSize * 2);
+      if (!_wavName.isEmpty()) {
+            _wav.setFileName(_wavName);
+            if (!_wav.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                  qDebug("null audio: cannot open <%s>", qPrintable(_wavName));
+                  return false;
+                  }
+            _wavFrames = 0;
+            return writeWavHeader();
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   writeWavHeader
+//    (re)write the header for the frames written so far
+//---------------------------------------------------------
+
+bool NullAudio::writeWavHeader()
+      {
+      const quint32 channels   = 2;
+      const quint32 frameBytes = channels * sizeof(float);
+      const quint32 dataBytes  = quint32(_wavFrames * frameBytes);
+      QByteArray h;
+      QDataStream ds(&h, QIODevice::WriteOnly);
+      ds.setByteOrder(QDataStream::LittleEndian);
+      ds.writeRawData("RIFF", 4);
+      ds << quint32(36 + dataBytes);
+      ds.writeRawData("WAVEfmt ", 8);
+      ds << quint32(16);                        // fmt chunk size
+      ds << quint16(3);                         // IEEE float
+      ds << quint16(channels);
+      ds << quint32(_sampleRate);
+      ds << quint32(_sampleRate * frameBytes);  // bytes per second
+      ds << quint16(frameBytes);
+      ds << quint16(32);                        // bits per sample
+      ds.writeRawData("data", 4);
+      ds << dataBytes;
+
+      qint64 pos = _wav.pos();
+      bool ok = _wav.seek(0) && _wav.write(h) == h.size();
+      if (pos > h.size())
+            ok = ok && _wav.seek(pos);
+      return ok;
+      }
+
+//---------------------------------------------------------
+//   cycle
+//    run one audio callback
+//---------------------------------------------------------
+
+void NullAudio::cycle()
+      {
+      const unsigned frames = _bufferSize;
+      if (_buffer.size() != frames * 2)
+            _buffer.resize(frames * 2);
+      float* buffer = _buffer.data();
+      std::fill(_buffer.begin(), _buffer.end(), 0.0f);
+
+      auto t1 = std::chrono::steady_clock::now();
+      if (_source)
+            _source(frames, buffer);
+      auto t2 = std::chrono::steady_clock::now();
+
+      qint64 us       = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+      qint64 periodUs = qint64(frames) * 1000000 / _sampleRate;
+      _stats.add(us, periodUs);
+
+      if (_wav.isOpen()) {
+            _wav.write(reinterpret_cast<const char*>(buffer), frames * 2 * sizeof(float));
+            _wavFrames += frames;
+            }
+      _frames += frames;
+      }
+
+//---------------------------------------------------------
+//   run
+//    run a number of callbacks on the calling thread
+//---------------------------------------------------------
+
+void NullAudio::run(int cycles)
+      {
+      for (int i = 0; i < cycles; ++i)
+            cycle();
+      if (_wav.isOpen())
+            writeWavHeader();
+      }
+
+//---------------------------------------------------------
+//   loop
+//    runs on the driver thread until stop() or until
+//    _maxFrames are done
+//---------------------------------------------------------
+
+void NullAudio::loop()
+      {
+      const auto period = std::chrono::microseconds(qint64(_bufferSize) * 1000000 / _sampleRate);
+      auto next = std::chrono::steady_clock::now();
+      while (_running) {
+            cycle();
+            if (_maxFrames && _frames >= _maxFrames)
+                  break;
+            if (_realtime) {
+                  next += period;
+                  std::this_thread::sleep_until(next);
+                  }
+            }
+      _running = false;
+      }
+
+//---------------------------------------------------------
+//   start
+//---------------------------------------------------------
+
+bool NullAudio::start(bool)
+      {
+      if (_running)
+            return true;
+      if (_thread.joinable())       // loop ended by itself
+            _thread.join();
+      _running = true;
+      _thread  = std::thread(&NullAudio::loop, this);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   stop
+//---------------------------------------------------------
+
+bool NullAudio::stop()
+      {
+      if (!_thread.joinable())
+            return true;
+      _running = false;
+      _thread.join();
+      if (_wav.isOpen()) {
+            writeWavHeader();
+            _wav.close();
+            }
+      qDebug("null audio: %s", qPrintable(_stats.toString()));
+      return true;
+      }
+
+//---------------------------------------------------------
+//   startTransport
+//---------------------------------------------------------
+
+void NullAudio::startTransport()
+      {
+      _state = Transport::PLAY;
+      }
+
+//---------------------------------------------------------
+//   stopTransport
+//---------------------------------------------------------
+
+void NullAudio::stopTransport()
+      {
+      _state = Transport::STOP;
+      }
+
+//---------------------------------------------------------
+//   getState
+//---------------------------------------------------------
+
+Transport NullAudio::getState()
+      {
+      return _state;
+      }
+
+} // namespace Ms
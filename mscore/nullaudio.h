@@ -0,0 +1,117 @@
+//=============================================================================
+//  MuseScore
+//  Linux Music Score Editor
+//
+//  Copyright (C) 2020 Werner Schweer and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#ifndef __NULLAUDIO_H__
+#define __NULLAUDIO_H__
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "driver.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   CallbackStats
+//    cost of the audio callbacks of a NullAudio driver
+//---------------------------------------------------------
+
+struct CallbackStats {
+      static const int BUCKETS = 24;      // bucket i counts callbacks taking [2^i, 2^(i+1)) microseconds
+
+      qint64 callbacks { 0 };
+      qint64 xruns     { 0 };             // callbacks taking longer than one buffer period
+      qint64 minUs     { 0 };
+      qint64 maxUs     { 0 };
+      qint64 totalUs   { 0 };
+      qint64 histogram[BUCKETS] { };
+
+      void add(qint64 us, qint64 periodUs);
+      qreal averageUs() const { return callbacks ? qreal(totalUs) / callbacks : 0.0; }
+      QString toString() const;
+      };
+
+//---------------------------------------------------------
+//   NullAudio
+//    audio driver without a sound card
+//
+//    Calls the sequencer with a fixed buffer size, either
+//    paced like a sound card would or as fast as possible,
+//    optionally writes the output to a WAV file and records
+//    the time spent in every callback.
+//
+//    Options are given as "key=value" pairs separated by
+//    commas, see setOptions().
+//---------------------------------------------------------
+
+class NullAudio : public Driver {
+   public:
+      typedef std::function<void(unsigned frames, float* buffer)> Source;
+
+   private:
+      Source _source;
+      int _sampleRate    { 44100 };
+      int _bufferSize    { 512 };
+      bool _realtime     { false };
+      qint64 _maxFrames  { 0 };           // stop after that many frames, 0 = never
+      QString _wavName;
+      QFile _wav;
+      qint64 _wavFrames  { 0 };
+
+      std::thread _thread;
+      std::atomic<bool> _running { false };
+      Transport _state;
+      std::vector<float> _buffer;
+      CallbackStats _stats;               // written by the driver thread
+      std::atomic<qint64> _frames { 0 };
+
+      void loop();
+      bool writeWavHeader();
+
+   public:
+      NullAudio(Seq*);
+      virtual ~NullAudio();
+
+      bool setOptions(const QString&);
+      void setSource(Source s)          { _source = s;     }
+      void setSampleRate(int val)       { _sampleRate = val; }
+      void setBufferSize(int val)       { _bufferSize = val; }
+      void setRealtime(bool val)        { _realtime = val;   }
+      void setMaxFrames(qint64 val)     { _maxFrames = val;  }
+      void setWavFile(const QString& s) { _wavName = s;    }
+
+      virtual bool init(bool hot = false) override;
+      virtual bool start(bool hotPlug = false) override;
+      virtual bool stop() override;
+      virtual void stopTransport() override;
+      virtual void startTransport() override;
+      virtual Transport getState() override;
+      virtual int sampleRate() const override { return _sampleRate; }
+      virtual int bufferSize() override       { return _bufferSize; }
+
+      void cycle();
+      void run(int cycles);
+      bool isRunning() const            { return _running; }
+      qint64 frames() const             { return _frames; }
+      // only valid while the driver thread is not running, i.e. after stop()
+      const CallbackStats& stats() const { return _stats; }
+      };
+
+} // namespace Ms
+#endif
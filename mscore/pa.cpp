@@ -264,16 +264,6 @@ Transport Portaudio::getState()
       return state;
       }
 
-//---------------------------------------------------------
-//   midiRead
-//---------------------------------------------------------
-
-void Portaudio::midiRead()
-      {
-      if (midiDriver)
-            midiDriver->read();
-      }
-
 //---------------------------------------------------------
 //   putEvent
 //---------------------------------------------------------
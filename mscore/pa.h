@@ -55,7 +55,6 @@ class Portaudio : public Driver {
       virtual void stopTransport();
       virtual Transport getState() override;
       virtual int sampleRate() const { return _sampleRate; }
-      virtual void midiRead();
 #ifdef USE_PORTMIDI
       virtual void putEvent(const NPlayEvent&, unsigned framePos);
 #endif
@@ -44,13 +44,14 @@ PortMidiDriver::PortMidiDriver(Seq* s)
       {
       inputId = -1;
       outputId = -1;
-      timer = 0;
       inputStream = 0;
       outputStream = 0;
+      quietTime = BUSY_TIME;
       }
 
 PortMidiDriver::~PortMidiDriver()
       {
+      stopInputThread();
       if (inputStream) {
             Pt_Stop();
             Pm_Close(inputStream);
@@ -113,10 +114,7 @@ bool PortMidiDriver::init()
                   }
             }
 
-      timer = new QTimer();
-      timer->setInterval(20);       // 20 msec
-      timer->start();
-      timer->connect(timer, SIGNAL(timeout()), seq, SLOT(midiInputReady()));
+      startInputThread();
       return true;
       }
 
@@ -156,8 +154,32 @@ void PortMidiDriver::getOutputPollFd(struct pollfd**, int* n)
       *n = 0;
       }
 
+//---------------------------------------------------------
+//   waitForInput
+//    PortMidi cannot block on input, poll it every
+//    millisecond while input arrives and every IDLE_POLL
+//    msec after BUSY_TIME without input
+//---------------------------------------------------------
+
+bool PortMidiDriver::waitForInput(int msec)
+      {
+      int waited = 0;
+      while (waited < msec) {
+            if (Pm_Poll(inputStream) > 0) {
+                  quietTime = 0;
+                  return true;
+                  }
+            int interval = quietTime < BUSY_TIME ? 1 : IDLE_POLL;
+            Pt_Sleep(interval);
+            waited    += interval;
+            quietTime += interval;
+            }
+      return false;
+      }
+
 //---------------------------------------------------------
 //   read
+//    called in the midi input thread
 //---------------------------------------------------------
 
 void PortMidiDriver::read()
@@ -174,17 +196,17 @@ void PortMidiDriver::read()
                   if (type == ME_NOTEON) {
                         int pitch = Pm_MessageData1(buffer[0].message);
                         int velo = Pm_MessageData2(buffer[0].message);
-                        mscore->midiNoteReceived(channel, pitch, velo);
+                        seq->midiInputEvent(NPlayEvent(ME_NOTEON, channel, pitch, velo));
                         }
                   else if (type == ME_NOTEOFF) {
                         int pitch = Pm_MessageData1(buffer[0].message);
                         (void)Pm_MessageData2(buffer[0].message); // read but ignore
-                        mscore->midiNoteReceived(channel, pitch, 0);
+                        seq->midiInputEvent(NPlayEvent(ME_NOTEOFF, channel, pitch, 0));
                         }
                   else if (type == ME_CONTROLLER) {
                         int param = Pm_MessageData1(buffer[0].message);
                         int value = Pm_MessageData2(buffer[0].message);
-                        mscore->midiCtrlReceived(param, value);
+                        seq->midiInputEvent(NPlayEvent(ME_CONTROLLER, channel, param, value));
                         }
                   }
             }
@@ -38,11 +38,17 @@ class Seq;
 //---------------------------------------------------------
 
 class PortMidiDriver : public MidiDriver {
+      static const int BUSY_TIME    = 1000;   // msec after the last input with 1 msec polling
+      static const int IDLE_POLL    = 20;     // poll interval in msec after that
+
       int inputId;
       int outputId;
-      QTimer* timer;
       PmStream* inputStream;
       PmStream* outputStream;
+      int quietTime;                    // msec since the last input, midi input thread only
+
+   protected:
+      virtual bool waitForInput(int msec);
 
    public:
       PortMidiDriver(Seq*);
@@ -3782,7 +3782,7 @@ void ScoreView::cmdTuplet(int n)
 //   midiNoteReceived
 //---------------------------------------------------------
 
-void ScoreView::midiNoteReceived(int pitch, bool chord, int velocity)
+void ScoreView::midiNoteReceived(int pitch, bool chord, int velocity, bool sounded)
       {
       qDebug("midiNoteReceived: pitch %d, chord %d, velocity %d", pitch, chord, velocity);
 
@@ -3790,6 +3790,7 @@ void ScoreView::midiNoteReceived(int pitch, bool chord, int velocity)
       ev.pitch = pitch;
       ev.chord = chord;
       ev.velocity = velocity;
+      ev.sounded = sounded;
 
       score()->masterScore()->enqueueMidiEvent(ev);
 
@@ -383,7 +383,7 @@ class ScoreView : public QWidget, public MuseScoreView {
       ScoreState mscoreState() const;
       void setCursorVisible(bool v);
       void showOmr(bool flag);
-      void midiNoteReceived(int pitch, bool chord, int velocity);
+      void midiNoteReceived(int pitch, bool chord, int velocity, bool sounded = false);
 
       virtual void moveCursor() override;
 
@@ -45,6 +45,9 @@
 #include "pianotools.h"
 
 #include "click.h"
+#include "globals.h"
+
+#include <chrono>
 
 #define OV_EXCLUDE_STATIC_CALLBACKS
 #include <vorbis/vorbisfile.h>
@@ -168,6 +171,13 @@ Seq::Seq()
       countInPlayPos    = countInEvents.cbegin();
       countInPlayFrame  = 0;
 
+      _midiInputEnabled      = false;
+      midiInputChannel       = -1;
+      midiInputTranspose     = 0;
+      midiRemoteKeys[0]      = 0;
+      midiRemoteKeys[1]      = 0;
+      midiInputNotesReported = 0;
+
       meterValue[0]     = 0.0;
       meterValue[1]     = 0.0;
       meterPeakValue[0] = 0.0;
@@ -753,6 +763,7 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
       float* p = buffer;
 
       processMessages();
+      playMidiInput(framesPerPeriod);
 
       if (state == Transport::PLAY) {
             if (!cs)
@@ -821,6 +832,8 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                                           else {
                                                 emit toGui('3');
                                                 }
+                                          if (cs->playMode() == PlayMode::SYNTHESIZER)
+                                                _synti->process(framePos, buffer);
                                           // Exit this function to avoid segmentation fault in Scoreview
                                           return;
                                           }
@@ -829,8 +842,9 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                         }
                   if (n) {
                         if (cs->playMode() == PlayMode::SYNTHESIZER) {
+                              // the synthesizer renders the whole period at
+                              // once below, playing every event at its frame
                               metronome(n, p, inCountIn);
-                              _synti->process(n, p);
                               p += n * 2;
                               *pPlayFrame  += n;
                               framesRemain -= n;
@@ -868,13 +882,17 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                   ++(*pPlayPos);
                   mutex.unlock();
                   }
-            if (framesRemain) {
-                  if (cs->playMode() == PlayMode::SYNTHESIZER) {
+            if (cs->playMode() == PlayMode::SYNTHESIZER) {
+                  if (framesRemain)
                         metronome(framesRemain, p, inCountIn);
-                        _synti->process(framesRemain, p);
-                        *pPlayFrame += framesRemain;
-                        }
-                  else {
+                  _synti->process(framesPerPeriod, buffer);
+                  *pPlayFrame += framesRemain;
+                  }
+            else {
+                  // the events still reach the synthesizer, the
+                  // audio comes from the recording
+                  _synti->process(0, buffer);
+                  if (framesRemain) {
                         int n = framesRemain;
                         while (n > 0) {
                               int section;
@@ -1436,22 +1454,124 @@ void Seq::guiToSeq(const SeqMsg& msg)
       }
 
 //---------------------------------------------------------
-//   eventToGui
+//   steadyUs
+//---------------------------------------------------------
+
+static qint64 steadyUs()
+      {
+      return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+//---------------------------------------------------------
+//   midiInputEvent
+//    called by the midi input thread (or the audio thread
+//    for JACK midi) for every event read from a midi device.
+//    Notes are played at the start of the next audio period
+//    unless the gui sounds them after note entry; all events
+//    are passed on to the gui.
+//---------------------------------------------------------
+
+void Seq::midiInputEvent(const NPlayEvent& event)
+      {
+      SeqMsg msg(SeqMsgId::MIDI_INPUT_EVENT, event);
+      msg.intVal = 0;
+      int type = event.type();
+      int channel = midiInputChannel;
+      if ((type == ME_NOTEON || type == ME_NOTEOFF) && channel != -1
+         && !(midiRemoteKeys[event.pitch() >> 6] & (quint64(1) << (event.pitch() & 63)))) {
+            int pitch = qBound(0, event.pitch() + midiInputTranspose, 127);
+            int velo  = type == ME_NOTEON ? event.velo() : 0;
+            SeqMsg note(SeqMsgId::MIDI_INPUT_EVENT, qreal(steadyUs()));
+            note.event = NPlayEvent(ME_NOTEON, channel, pitch, velo);
+            if (!midiInput.isFull()) {
+                  midiInput.enqueue(note);
+                  msg.intVal = 1;
+                  }
+            }
+      fromSeq.enqueue(msg);
+      }
+
+//---------------------------------------------------------
+//   playMidiInput
+//    play notes received by midiInputEvent() in the
+//    realtime thread
+//---------------------------------------------------------
+
+void Seq::playMidiInput(unsigned framesPerPeriod)
+      {
+      if (midiInput.empty())
+            return;
+      const qint64 now      = steadyUs();
+      const qint64 periodUs = qint64(framesPerPeriod) * 1000000 / MScore::sampleRate;
+      while (!midiInput.empty()) {
+            SeqMsg msg = midiInput.dequeue();
+            if (state == Transport::STOP || state == Transport::PLAY)
+                  putEvent(msg.event);
+            if (msg.event.velo())
+                  _midiInputLatency.add(now - qint64(msg.realVal) + periodUs);
+            }
+      }
+
+//---------------------------------------------------------
+//   updateMidiInput
+//    tell the midi input thread whether input is enabled
+//    and where to sound notes. It makes the same choice as
+//    Score::processMidiInput(), which then leaves the notes
+//    alone; in step time note entry the entered notes are
+//    played by the gui.
 //---------------------------------------------------------
 
-void Seq::eventToGui(NPlayEvent e)
+void Seq::updateMidiInput()
       {
-      fromSeq.enqueue(SeqMsg(SeqMsgId::MIDI_INPUT_EVENT, e));
+      int channel   = -1;
+      int transpose = 0;
+      Score* score  = cv ? cv->score() : 0;
+      bool enabled  = mscore->midiinEnabled();
+      if (score && score->nstaves() && enabled && mscore->midiRecordId() == -1
+         && !QApplication::activeModalWidget()) {
+            NoteEntryMethod entryMethod = score->inputState().noteEntryMethod();
+            if (!score->noteEntryMode()
+               || entryMethod == NoteEntryMethod::REALTIME_AUTO
+               || entryMethod == NoteEntryMethod::REALTIME_MANUAL) {
+                  int staffIdx = score->selection().staffStart();
+                  Part* p;
+                  if (staffIdx < 0 || staffIdx >= score->nstaves())
+                        p = score->staff(0)->part();
+                  else
+                        p = score->staff(staffIdx)->part();
+                  if (p) {
+                        channel = p->instrument()->channel(0)->channel();
+                        if (!score->styleB(Sid::concertPitch))
+                              transpose = p->instrument(score->selection().tickStart())->transpose().chromatic;
+                        }
+                  }
+            }
+      quint64 keys[2] = { 0, 0 };
+      if (preferences.getBool(PREF_IO_MIDI_USEREMOTECONTROL)) {
+            for (int i = 0; i < MIDI_REMOTES; ++i) {
+                  const MidiRemote& r = preferences.midiRemote(i);
+                  if (r.type == MIDI_REMOTE_TYPE_NOTEON && r.data >= 0 && r.data < 128)
+                        keys[r.data >> 6] |= quint64(1) << (r.data & 63);
+                  }
+            }
+      midiRemoteKeys[0]  = keys[0];
+      midiRemoteKeys[1]  = keys[1];
+      midiInputTranspose = transpose;
+      midiInputChannel   = channel;
+      _midiInputEnabled  = enabled;
       }
 
 //---------------------------------------------------------
-//   midiInputReady
+//   MidiInputLatency::add
+//    called in the realtime thread only
 //---------------------------------------------------------
 
-void Seq::midiInputReady()
+void MidiInputLatency::add(qint64 us)
       {
-      if (_driver)
-            _driver->midiRead();
+      totalUs += us;
+      if (us > maxUs)
+            maxUs = us;
+      ++notes;
       }
 
 //---------------------------------------------------------
@@ -1517,7 +1637,7 @@ void Seq::putEvent(const NPlayEvent& event, unsigned framePos)
 
       // audio
       int syntiIdx= _synti->index(cs->midiMapping(channel)->articulation()->synti());
-      _synti->play(event, syntiIdx);
+      _synti->schedule(event, syntiIdx, framePos);
 
       // midi
       if (_driver != 0 && (preferences.getBool(PREF_IO_JACK_USEJACKMIDI) || preferences.getBool(PREF_IO_ALSA_USEALSAAUDIO) || preferences.getBool(PREF_IO_PORTAUDIO_USEPORTAUDIO)))
@@ -1540,18 +1660,25 @@ void Seq::heartBeatTimeout()
             sc->setMeter(meterValue[0], meterValue[1], meterPeakValue[0], meterPeakValue[1]);
             }
 
+      updateMidiInput();
       while (!fromSeq.empty()) {
             SeqMsg msg = fromSeq.dequeue();
             if (msg.id == SeqMsgId::MIDI_INPUT_EVENT) {
                   int type = msg.event.type();
+                  bool sounded = msg.intVal;
                   if (type == ME_NOTEON)
-                        mscore->midiNoteReceived(msg.event.channel(), msg.event.pitch(), msg.event.velo());
+                        mscore->midiNoteReceived(msg.event.channel(), msg.event.pitch(), msg.event.velo(), sounded);
                   else if (type == ME_NOTEOFF)
-                        mscore->midiNoteReceived(msg.event.channel(), msg.event.pitch(), 0);
+                        mscore->midiNoteReceived(msg.event.channel(), msg.event.pitch(), 0, sounded);
                   else if (type == ME_CONTROLLER)
                         mscore->midiCtrlReceived(msg.event.controller(), msg.event.value());
                   }
             }
+      if (midiInputTrace && _midiInputLatency.notes != midiInputNotesReported) {
+            midiInputNotesReported = _midiInputLatency.notes;
+            qDebug("MidiIn: %d notes sounded, latency avg %.0fus, max %lldus",
+               midiInputNotesReported, _midiInputLatency.averageUs(), qint64(_midiInputLatency.maxUs));
+            }
 
       if (state != Transport::PLAY || inCountIn)
             return;
@@ -88,6 +88,21 @@ class SeqMsgFifo : public FifoBase {
       SeqMsg dequeue();                   // remove object from fifo
       };
 
+//---------------------------------------------------------
+//   MidiInputLatency
+//    time from reading a midi input note to the end of
+//    the audio period it is rendered in
+//---------------------------------------------------------
+
+struct MidiInputLatency {
+      std::atomic<int> notes { 0 };
+      std::atomic<qint64> totalUs { 0 };
+      std::atomic<qint64> maxUs { 0 };
+
+      void add(qint64 us);
+      double averageUs() const { return notes ? double(totalUs) / notes : 0.0; }
+      };
+
 // this are also the jack audio transport states:
 enum class Transport : char {
       STOP=0,
@@ -126,6 +141,13 @@ class Seq : public QObject, public Sequencer {
 
       SeqMsgFifo toSeq;
       SeqMsgFifo fromSeq;
+      SeqMsgFifo midiInput;               // notes from the midi input thread, played in process()
+      std::atomic<bool> _midiInputEnabled;  // midi input preference, for the midi input thread
+      std::atomic<int> midiInputChannel;  // channel midi input notes sound on, -1: sounded by the gui
+      std::atomic<int> midiInputTranspose;
+      std::atomic<quint64> midiRemoteKeys[2];   // pitches used for midi remote control
+      MidiInputLatency _midiInputLatency;
+      int midiInputNotesReported;
       Driver* _driver;
       MasterSynthesizer* _synti;
 
@@ -176,6 +198,8 @@ class Seq : public QObject, public Sequencer {
       void unmarkNotes();
       void updateSynthesizerState(int tick1, int tick2);
       void addCountInClicks();
+      void updateMidiInput();
+      void playMidiInput(unsigned framesPerPeriod);
 
       int getPlayStartUtick();
 
@@ -184,7 +208,6 @@ class Seq : public QObject, public Sequencer {
    private slots:
       void seqMessage(int msg, int arg = 0);
       void heartBeatTimeout();
-      void midiInputReady();
       void setPlaylistChanged() { playlistChanged = true; }
       void handleTimeSigTempoChanged();
 
@@ -259,7 +282,8 @@ class Seq : public QObject, public Sequencer {
       virtual void startNote(int channel, int, int, int, double nt) override;
       virtual void playMetronomeBeat(BeatType type) override;
 
-      void eventToGui(NPlayEvent);
+      void midiInputEvent(const NPlayEvent&);
+      bool midiInputEnabled() const    { return _midiInputEnabled; }
       void stopNoteTimer();
       void recomputeMaxMidiOutPort();
       float metronomeGain() const      { return metronomeVolume; }
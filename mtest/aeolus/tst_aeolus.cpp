@@ -0,0 +1,148 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "aeolus/rankwave.h"
+#include "aeolus/blockops.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestAeolus
+//---------------------------------------------------------
+
+class TestAeolus : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      std::vector<float> ramp(int n, float scale) const;
+
+   private slots:
+      void initTestCase();
+      void blockKernels();
+      void fullOrganChord();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestAeolus::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   ramp
+//---------------------------------------------------------
+
+std::vector<float> TestAeolus::ramp(int n, float scale) const
+      {
+      std::vector<float> v(n);
+      for (int i = 0; i < n; ++i)
+            v[i] = scale * sinf(0.37f * i);
+      return v;
+      }
+
+//---------------------------------------------------------
+//   blockKernels
+//    compare the block kernels with the scalar loops they
+//    replace, for lengths which are no multiple of the
+//    vector width and unaligned pointers too
+//---------------------------------------------------------
+
+void TestAeolus::blockKernels()
+      {
+      for (int n : { 0, 1, 3, 4, 7, 64 }) {
+            std::vector<float> p = ramp(n + 2, 0.5f);
+            std::vector<float> q = ramp(n + 1, 0.25f);
+            std::vector<float> ref = q;
+
+            AeolusBlock::add(q.data() + 1, p.data() + 1, n);
+            for (int i = 0; i < n; ++i)
+                  ref[i + 1] += p[i + 1];
+            for (int i = 0; i <= n; ++i)
+                  QCOMPARE(q[i], ref[i]);
+
+            float g = 0.9f, dg = 0.01f;
+            AeolusBlock::addRamp(q.data(), p.data(), n, g, dg);
+            for (int i = 0; i < n; ++i) {
+                  ref[i] += g * p[i];
+                  g -= dg;
+                  }
+            for (int i = 0; i <= n; ++i)
+                  QVERIFY(qAbs(q[i] - ref[i]) < 1e-5f);
+
+            float y = 0.2f, dy = 0.013f;
+            g = 0.8f;
+            AeolusBlock::addInterp(q.data(), p.data(), n, y, dy, g, dg);
+            for (int i = 0; i < n; ++i) {
+                  ref[i] += g * (p[i] + y * (p[i + 1] - p[i]));
+                  g -= dg;
+                  y += dy;
+                  }
+            for (int i = 0; i <= n; ++i)
+                  QVERIFY(qAbs(q[i] - ref[i]) < 1e-5f);
+            }
+      }
+
+//---------------------------------------------------------
+//   fullOrganChord
+//    play a six note chord on eight ranks with a rich
+//    harmonic spectrum
+//---------------------------------------------------------
+
+void TestAeolus::fullOrganChord()
+      {
+      const int RANKS = 8;
+      float scale[12];
+      for (int i = 0; i < 12; ++i)
+            scale[i] = exp2f(i / 12.0f);
+
+      Addsynth synth;
+      for (int h = 0; h < 16; ++h) {
+            for (int i = 0; i < N_NOTE; ++i)
+                  synth._h_lev.setv(h, i, -6.0f * h);
+            }
+
+      alignas(16) float out[4 * PERIOD];
+      std::vector<Rankwave*> ranks;
+      for (int r = 0; r < RANKS; ++r) {
+            Rankwave* w = new Rankwave(synth._n0, synth._n1);
+            synth._fn = 1 << (r % 3);         // 8', 4' and 2' pitch
+            w->gen_waves(&synth, 44100.0f, 440.0f, scale, r);
+            w->set_param(out, 0, 'C');
+            for (int note : { 48, 52, 55, 60, 64, 67 })
+                  w->note_on(note);
+            ranks.push_back(w);
+            }
+
+      float peak = 0.0f;
+      QBENCHMARK {
+            for (int period = 0; period < 100; ++period) {
+                  memset(out, 0, sizeof(out));
+                  for (Rankwave* w : ranks)
+                        w->play(1);
+                  for (float v : out)
+                        peak = qMax(peak, qAbs(v));
+                  }
+            }
+      QVERIFY(peak > 0.0f);
+      QVERIFY(std::isfinite(peak));
+
+      for (Rankwave* w : ranks)
+            delete w;
+      }
+
+QTEST_MAIN(TestAeolus)
+#include "tst_aeolus.moc"
@@ -0,0 +1,250 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "fluid/fluid.h"
+#include "mscore/preferences.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+static const int FRAMES = 256;
+
+//---------------------------------------------------------
+//   TestFluid
+//---------------------------------------------------------
+
+class TestFluid : public QObject, public MTest
+      {
+      Q_OBJECT
+      float samplerate = 44100;
+
+      FluidS::Fluid* createSynth();
+      void replay(FluidS::Fluid*, const EventMap&, int frames, std::vector<float>* out);
+      void replayScheduled(FluidS::Fluid*, const EventMap&, int frames, std::vector<float>* out);
+
+   private slots:
+      void initTestCase();
+      void filterTable();
+      void controllerBatching();
+      void scheduledEvents();
+      void controllerBenchmark();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestFluid::initTestCase()
+      {
+      initMTest();
+      preferences.setPreference(PREF_APP_PATHS_MYSOUNDFONTS, QString(TESTROOT "/share/sound"));
+      }
+
+//---------------------------------------------------------
+//   createSynth
+//---------------------------------------------------------
+
+FluidS::Fluid* TestFluid::createSynth()
+      {
+      FluidS::Fluid* synth = new FluidS::Fluid();
+      synth->init(samplerate);
+      if (!synth->loadSoundFonts(QStringList("FluidR3Mono_GM.sf3")))
+            qFatal("cannot load FluidR3Mono_GM.sf3");
+      for (int ch = 0; ch < 4; ++ch)
+            synth->play(NPlayEvent(ME_CONTROLLER, ch, CTRL_PROGRAM, 40 + ch));
+      return synth;
+      }
+
+//---------------------------------------------------------
+//   replay
+//    events are keyed by frame; render up to each event,
+//    then send it
+//---------------------------------------------------------
+
+void TestFluid::replay(FluidS::Fluid* synth, const EventMap& events, int frames, std::vector<float>* out)
+      {
+      std::vector<float> buffer(FRAMES * 2);
+      std::vector<float> effect1(FRAMES * 2);
+      std::vector<float> effect2(FRAMES * 2);
+      int pos = 0;
+      auto e = events.cbegin();
+      while (pos < frames) {
+            while (e != events.cend() && e->first <= pos) {
+                  synth->play(e->second);
+                  ++e;
+                  }
+            int n = qMin(FRAMES, frames - pos);
+            if (e != events.cend())
+                  n = qMin(n, e->first - pos);
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            std::fill(effect1.begin(), effect1.end(), 0.0f);
+            std::fill(effect2.begin(), effect2.end(), 0.0f);
+            synth->process(n, buffer.data(), effect1.data(), effect2.data());
+            if (out)
+                  out->insert(out->end(), buffer.begin(), buffer.begin() + n * 2);
+            pos += n;
+            }
+      }
+
+//---------------------------------------------------------
+//   replayScheduled
+//    like replay(), but pass the events of every block to
+//    processEvents()
+//---------------------------------------------------------
+
+void TestFluid::replayScheduled(FluidS::Fluid* synth, const EventMap& events, int frames, std::vector<float>* out)
+      {
+      std::vector<float> buffer(FRAMES * 2);
+      std::vector<float> effect1(FRAMES * 2);
+      std::vector<float> effect2(FRAMES * 2);
+      std::vector<TimedEvent> block;
+      auto e = events.cbegin();
+      for (int pos = 0; pos < frames; pos += FRAMES) {
+            int n = qMin(FRAMES, frames - pos);
+            block.clear();
+            for (; e != events.cend() && e->first < pos + n; ++e)
+                  block.push_back(TimedEvent { unsigned(qMax(e->first - pos, 0)), e->second });
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            std::fill(effect1.begin(), effect1.end(), 0.0f);
+            std::fill(effect2.begin(), effect2.end(), 0.0f);
+            synth->processEvents(n, buffer.data(), effect1.data(), effect2.data(), block);
+            if (out)
+                  out->insert(out->end(), buffer.begin(), buffer.begin() + n * 2);
+            }
+      }
+
+//---------------------------------------------------------
+//   filterTable
+//    the cached filter coefficients are within a cent of
+//    the exact cutoff, and clamped to 5 Hz .. 0.45 * rate
+//---------------------------------------------------------
+
+void TestFluid::filterTable()
+      {
+      FluidS::Fluid synth;
+      synth.init(samplerate);
+
+      const double cents = 6900.0 + 1200.0 * log2(1000.0 / 440.0);
+      const auto& c = synth.filterCoeff(synth.filterIndex(cents));
+      const double omega = 2.0 * M_PI * 1000.0 / samplerate;
+      QVERIFY(qAbs(c.sin - sin(omega)) < 1e-4);
+      QVERIFY(qAbs(c.cos - cos(omega)) < 1e-4);
+
+      const auto& lo = synth.filterCoeff(synth.filterIndex(-10000.0f));
+      QVERIFY(qAbs(lo.sin - sin(2.0 * M_PI * 5.0 / samplerate)) < 1e-6);
+      const auto& hi = synth.filterCoeff(synth.filterIndex(30000.0f));
+      QVERIFY(qAbs(hi.cos - cos(2.0 * M_PI * 0.45)) < 1e-6);
+      }
+
+//---------------------------------------------------------
+//   controllerBatching
+//    many controller changes between two blocks sound
+//    the same as only the last one
+//---------------------------------------------------------
+
+void TestFluid::controllerBatching()
+      {
+      EventMap dense;
+      EventMap sparse;
+      for (EventMap* m : { &dense, &sparse }) {
+            m->insert(std::make_pair(0, NPlayEvent(ME_NOTEON, 0, 60, 100)));
+            m->insert(std::make_pair(0, NPlayEvent(ME_NOTEON, 0, 64, 100)));
+            }
+      for (int i = 0; i < 50; ++i)
+            dense.insert(std::make_pair(1024, NPlayEvent(ME_CONTROLLER, 0, CTRL_EXPRESSION, 127 - i)));
+      sparse.insert(std::make_pair(1024, NPlayEvent(ME_CONTROLLER, 0, CTRL_EXPRESSION, 127 - 49)));
+
+      std::vector<float> a;
+      std::vector<float> b;
+      FluidS::Fluid* synth = createSynth();
+      replay(synth, dense, 4096, &a);
+      delete synth;
+      synth = createSynth();
+      replay(synth, sparse, 4096, &b);
+      delete synth;
+
+      QCOMPARE(a.size(), b.size());
+      float peak = 0.0f;
+      for (size_t i = 0; i < a.size(); ++i) {
+            QVERIFY(qAbs(a[i] - b[i]) < 1e-6f);
+            peak = qMax(peak, qAbs(a[i]));
+            }
+      QVERIFY(peak > 0.0f);
+      }
+
+//---------------------------------------------------------
+//   scheduledEvents
+//    events passed with the block sound at the same frames
+//    as events played between process() calls
+//---------------------------------------------------------
+
+void TestFluid::scheduledEvents()
+      {
+      EventMap events;
+      for (int i = 0; i < 24; ++i) {
+            int frame = i * 97;
+            int key   = 48 + (i * 5) % 24;
+            events.insert(std::make_pair(frame, NPlayEvent(ME_NOTEON, i % 4, key, 100)));
+            events.insert(std::make_pair(frame + 300, NPlayEvent(ME_NOTEON, i % 4, key, 0)));
+            events.insert(std::make_pair(frame + 13, NPlayEvent(ME_CONTROLLER, i % 4, CTRL_EXPRESSION, 60 + i)));
+            }
+
+      std::vector<float> a;
+      std::vector<float> b;
+      FluidS::Fluid* synth = createSynth();
+      replay(synth, events, 4096, &a);
+      delete synth;
+      synth = createSynth();
+      replayScheduled(synth, events, 4096, &b);
+      delete synth;
+
+      QCOMPARE(a.size(), b.size());
+      float peak = 0.0f;
+      for (size_t i = 0; i < a.size(); ++i) {
+            QVERIFY(qAbs(a[i] - b[i]) < 1e-6f);
+            peak = qMax(peak, qAbs(a[i]));
+            }
+      QVERIFY(peak > 0.0f);
+      }
+
+//---------------------------------------------------------
+//   controllerBenchmark
+//    a chord on four channels with expression curves
+//    like the ones rendered for hairpins, one controller
+//    event per channel every 32 frames
+//---------------------------------------------------------
+
+void TestFluid::controllerBenchmark()
+      {
+      const int frames = int(samplerate) * 2;
+      EventMap events;
+      for (int ch = 0; ch < 4; ++ch) {
+            for (int key : { 48, 55, 60, 64 })
+                  events.insert(std::make_pair(0, NPlayEvent(ME_NOTEON, ch, key + ch * 2, 90)));
+            for (int f = 32; f < frames; f += 32) {
+                  int value = 40 + (f / 32 + ch * 7) % 80;
+                  events.insert(std::make_pair(f, NPlayEvent(ME_CONTROLLER, ch, CTRL_EXPRESSION, value)));
+                  }
+            }
+
+      FluidS::Fluid* synth = createSynth();
+      QBENCHMARK {
+            replay(synth, events, frames, nullptr);
+            synth->allNotesOff(-1);
+            }
+      delete synth;
+      }
+
+QTEST_MAIN(TestFluid)
+#include "tst_fluid.moc"
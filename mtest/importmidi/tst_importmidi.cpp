@@ -35,6 +35,7 @@
 #include "mscore/importmidi/importmidi_model.h"
 #include "mscore/importmidi/importmidi_lyrics.h"
 #include "mscore/preferences.h"
+#include "midi/midifile.h"
 
 
 namespace Ms {
@@ -404,6 +405,9 @@ class TestImportMidi : public QObject, public MTest
 
       // gui - tracks model
       void testGuiTracksModel();
+
+      // MIDI file parser robustness
+      void midiFileMalformed();
       };
 
 //---------------------------------------------------------
@@ -1199,6 +1203,50 @@ void TestImportMidi::testGuiTracksModel()
       QCOMPARE(model.flags(model.index(0, channelCol)), notEditableFlags);
       }
 
+//---------------------------------------------------------
+//   midiFileMalformed
+//    feed truncated and corrupted versions of a multi-track
+//    file to the parser; it may reject them but must not crash
+//---------------------------------------------------------
+
+static bool readMidiData(const QByteArray& data)
+      {
+      QBuffer buffer;
+      buffer.setData(data);
+      buffer.open(QIODevice::ReadOnly);
+      MidiFile mf;
+      try {
+            return mf.read(&buffer);
+            }
+      catch (QString) {
+            return false;
+            }
+      }
+
+void TestImportMidi::midiFileMalformed()
+      {
+      QFile f(midiFilePath("instrument_3staff_organ"));
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      const QByteArray data = f.readAll();
+      f.close();
+      QVERIFY(data.size() > 22);
+      QVERIFY(readMidiData(data));
+
+      // truncated at every position
+      for (int len = 0; len < data.size(); ++len)
+            readMidiData(data.left(len));
+
+      // random bytes corrupted, deterministic sequence
+      quint32 seed = 12345;
+      auto rnd = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 16) & 0x7fff; };
+      for (int i = 0; i < 2000; ++i) {
+            QByteArray d = data;
+            const int n = 1 + rnd() % 4;
+            for (int k = 0; k < n; ++k)
+                  d[int(rnd() % d.size())] = char(rnd() & 0xff);
+            readMidiData(d);
+            }
+      }
 
 QTEST_MAIN(TestImportMidi)
 
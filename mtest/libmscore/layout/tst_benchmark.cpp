@@ -39,6 +39,9 @@ class TestBenchmark : public QObject, public MTest
       void benchmark1();
       void benchmark2();
       void benchmark4();            // incremental layout (one page)
+      void benchmark5();            // layout with multi measure rests
+      void benchmark6_data();
+      void benchmark6();            // vertical justification for different page heights
       };
 
 //---------------------------------------------------------
@@ -89,6 +92,37 @@ void TestBenchmark::benchmark4()
             }
       }
 
+void TestBenchmark::benchmark5()
+      {
+      score->style().set(Sid::createMultiMeasureRests, true);
+      score->doLayout();
+      QBENCHMARK {                        // reuses the mmrest measures
+            score->doLayout();
+            }
+      score->style().set(Sid::createMultiMeasureRests, false);
+      }
+
+void TestBenchmark::benchmark6_data()
+      {
+      QTest::addColumn<qreal>("pageHeight");
+      QTest::newRow("A5")     << 8.27;
+      QTest::newRow("Letter") << 11.0;
+      QTest::newRow("A4")     << 11.69;
+      QTest::newRow("A3")     << 16.54;
+      }
+
+void TestBenchmark::benchmark6()
+      {
+      QFETCH(qreal, pageHeight);
+      const QVariant oldHeight = score->style().value(Sid::pageHeight);
+      score->style().set(Sid::pageHeight, pageHeight);
+      score->doLayout();
+      QBENCHMARK {
+            score->doLayout();
+            }
+      score->style().set(Sid::pageHeight, oldHeight);
+      }
+
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
 
@@ -15,6 +15,7 @@
 #include "libmscore/measure.h"
 #include "libmscore/page.h"
 #include "libmscore/score.h"
+#include "libmscore/segment.h"
 #include "libmscore/staff.h"
 #include "libmscore/system.h"
 #include "libmscore/tuplet.h"
@@ -40,6 +41,7 @@ class TestLayoutElements : public QObject, public MTest
       void tstLayoutElements()  { tstLayoutAll("layout_elements.mscx"); }
       void tstLayoutTablature() { tstLayoutAll("layout_elements_tab.mscx"); }
       void tstLayoutMoonlight() { tstLayoutAll("moonlight.mscx");       }
+      void tstSegmentShapes();
       // FIXME goldberg.mscx does not pass the test because of some
       // TimeSig and Clef elements. Need to check it later!
 //       void tstLayoutGoldberg()  { tstLayoutAll("goldberg.mscx");        }
@@ -113,6 +115,38 @@ void TestLayoutElements::tstLayoutAll(QString file)
             }
       }
 
+//---------------------------------------------------------
+//   tstSegmentShapes
+//    Segment::createShapes() builds all staff shapes in one
+//    pass; check it against createShape() for every staff
+//---------------------------------------------------------
+
+void TestLayoutElements::tstSegmentShapes()
+      {
+      MasterScore* score = readScore(DIR + "moonlight.mscx");
+      for (Segment* s = score->firstSegment(SegmentType::All); s; s = s->next1()) {
+            s->createShapes();
+            const std::vector<Shape> shapes = s->shapes();
+            const bool visible = s->visible();
+            std::vector<Shape> staffShapes;
+            bool staffVisible = false;
+            for (int staffIdx = 0; staffIdx < score->nstaves(); ++staffIdx) {
+                  s->setVisible(false);
+                  s->createShape(staffIdx);
+                  staffVisible = staffVisible || s->visible();
+                  staffShapes.push_back(s->staffShape(staffIdx));
+                  }
+            QCOMPARE(staffVisible, visible);
+            QCOMPARE(int(staffShapes.size()), int(shapes.size()));
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                  QCOMPARE(staffShapes[i].size(), shapes[i].size());
+                  for (size_t k = 0; k < shapes[i].size(); ++k)
+                        QCOMPARE(QRectF(staffShapes[i][k]), QRectF(shapes[i][k]));
+                  }
+            }
+      delete score;
+      }
+
 QTEST_MAIN(TestLayoutElements)
 #include "tst_layout_elements.moc"
 
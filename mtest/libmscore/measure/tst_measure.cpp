@@ -25,6 +25,7 @@
 #include "libmscore/element.h"
 #include "libmscore/system.h"
 #include "libmscore/durationtype.h"
+#include "libmscore/layout.h"
 #include "mtest/testutils.h"
 
 #define DIR QString("libmscore/measure/")
@@ -57,6 +58,8 @@ class TestMeasure : public QObject, public MTest
 //      void minWidth();
       void undoDelInitialVBox_269919();
       void mmrest();
+      void optimalLineBreaks();
+      void lineBreakOptimalFit();
 
       void gap();
       void checkMeasure();
@@ -522,6 +525,81 @@ void TestMeasure::mmrest()
       delete score;
       }
 
+//---------------------------------------------------------
+///   optimalLineBreaks
+///    measure widths for which filling every system as far as
+///    possible leaves one nearly empty system in the middle
+//---------------------------------------------------------
+
+void TestMeasure::optimalLineBreaks()
+      {
+      const qreal width = 100.0;
+      const std::vector<qreal> core { 40.0, 30.0, 30.0, 40.0, 20.0, 50.0, 60.0 };
+      const std::vector<qreal> header(core.size(), 0.0);
+      const std::vector<qreal> trailer(core.size(), 0.0);
+      std::vector<bool> noBreak(core.size(), false);
+
+      // greedy: 40+30+30 | 40+20 | 50 | 60, free space 0, 40, 50
+      std::vector<int> greedy;
+      qreal w = 0.0;
+      for (int i = 0; i < int(core.size()); ++i) {
+            if (w + core[i] > width) {
+                  greedy.push_back(i - 1);
+                  w = 0.0;
+                  }
+            w += core[i];
+            }
+      greedy.push_back(int(core.size()) - 1);
+      QCOMPARE(greedy, std::vector<int>({ 2, 4, 5, 6 }));
+
+      // optimal: 40+30 | 30+40 | 20+50 | 60, free space 30, 30, 30
+      QCOMPARE(Ms::optimalLineBreaks(header, core, trailer, noBreak, width, width), std::vector<int>({ 1, 3, 5, 6 }));
+
+      // no break after the second measure
+      noBreak[1] = true;
+      QCOMPARE(Ms::optimalLineBreaks(header, core, trailer, noBreak, width, width), std::vector<int>({ 2, 4, 5, 6 }));
+      noBreak[1] = false;
+
+      // a narrower first system, e.g. with long instrument names: 40 | 30+30+40 | 20+50 | 60
+      QCOMPARE(Ms::optimalLineBreaks(header, core, trailer, noBreak, 60.0, width), std::vector<int>({ 0, 3, 5, 6 }));
+
+      // the system header counts against the width: 35+40 | 35+30+30 | 35+40+20 | 35+50 | 35+60
+      std::vector<qreal> header2(core.size(), 35.0);
+      QCOMPARE(Ms::optimalLineBreaks(header2, core, trailer, noBreak, width, width), std::vector<int>({ 0, 2, 4, 5, 6 }));
+      }
+
+//---------------------------------------------------------
+///   lineBreakOptimalFit
+///    all measures are placed in systems, and a second
+///    layout keeps the system breaks
+//---------------------------------------------------------
+
+void TestMeasure::lineBreakOptimalFit()
+      {
+      MasterScore* score = readScore(DIR + "measure-2.mscx");
+      score->startCmd();
+      score->undo(new ChangeStyleVal(score, Sid::lineBreakOptimalFit, true));
+      score->setLayoutAll();
+      score->endCmd();
+
+      QList<Measure*> firstMeasures;
+      for (System* s : score->systems()) {
+            if (s->firstMeasure())
+                  firstMeasures.append(s->firstMeasure());
+            }
+      for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure())
+            QVERIFY(m->system());
+      QVERIFY(firstMeasures.size() > 1);
+
+      score->doLayout();
+      QList<Measure*> firstMeasures2;
+      for (System* s : score->systems()) {
+            if (s->firstMeasure())
+                  firstMeasures2.append(s->firstMeasure());
+            }
+      QCOMPARE(firstMeasures2, firstMeasures);
+      delete score;
+      }
 
 QTEST_MAIN(TestMeasure)
 
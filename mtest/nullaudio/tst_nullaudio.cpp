@@ -0,0 +1,167 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <QtEndian>
+#include "mtest/testutils.h"
+#include "mscore/nullaudio.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestNullAudio
+//---------------------------------------------------------
+
+class TestNullAudio : public QObject, public MTest
+      {
+      Q_OBJECT
+
+   private slots:
+      void initTestCase();
+      void options();
+      void callbacks();
+      void frameLimit();
+      void wavFile();
+      void benchmark();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestNullAudio::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   options
+//---------------------------------------------------------
+
+void TestNullAudio::options()
+      {
+      NullAudio driver(0);
+      QVERIFY(driver.setOptions("frames=128,rate=48000,seconds=2,realtime"));
+      QCOMPARE(driver.bufferSize(), 128);
+      QCOMPARE(driver.sampleRate(), 48000);
+      QVERIFY(!driver.setOptions("frames=abc"));
+      QVERIFY(!driver.setOptions("unknown=1"));
+      QVERIFY(!driver.setOptions("frames=0"));
+      }
+
+//---------------------------------------------------------
+//   callbacks
+//    every callback is counted once in the histogram
+//---------------------------------------------------------
+
+void TestNullAudio::callbacks()
+      {
+      NullAudio driver(0);
+      QVERIFY(driver.setOptions("frames=64"));
+      QVERIFY(driver.init());
+      unsigned calls = 0;
+      driver.setSource([&calls](unsigned frames, float*) { QCOMPARE(frames, 64u); ++calls; });
+      driver.run(100);
+
+      const CallbackStats& stats = driver.stats();
+      QCOMPARE(calls, 100u);
+      QCOMPARE(driver.frames(), qint64(6400));
+      QCOMPARE(stats.callbacks, qint64(100));
+      qint64 n = 0;
+      for (int i = 0; i < CallbackStats::BUCKETS; ++i)
+            n += stats.histogram[i];
+      QCOMPARE(n, qint64(100));
+      QVERIFY(stats.minUs <= stats.maxUs);
+      }
+
+//---------------------------------------------------------
+//   frameLimit
+//    the driver thread stops by itself after seconds=
+//---------------------------------------------------------
+
+void TestNullAudio::frameLimit()
+      {
+      NullAudio driver(0);
+      QVERIFY(driver.setOptions("frames=64,rate=6400,seconds=1"));
+      QVERIFY(driver.init());
+      driver.setSource([](unsigned, float*) {});
+      QVERIFY(driver.start());
+      QTRY_VERIFY(!driver.isRunning());
+      QVERIFY(driver.stop());
+      QCOMPARE(driver.frames(), qint64(6400));
+      QCOMPARE(driver.stats().callbacks, qint64(100));
+      }
+
+//---------------------------------------------------------
+//   wavFile
+//---------------------------------------------------------
+
+void TestNullAudio::wavFile()
+      {
+      QString name("nullaudio-test.wav");
+      {
+      NullAudio driver(0);
+      QVERIFY(driver.setOptions("frames=32,rate=22050,wav=" + name));
+      QVERIFY(driver.init());
+      float value = 0.0f;
+      driver.setSource([&value](unsigned frames, float* p) {
+            for (unsigned i = 0; i < frames * 2; ++i)
+                  *p++ = value;
+            value += 0.125f;
+            });
+      driver.run(4);
+      }
+      QFile f(name);
+      QVERIFY(f.open(QIODevice::ReadOnly));
+      QByteArray data = f.readAll();
+      QCOMPARE(data.size(), 44 + 4 * 32 * 2 * int(sizeof(float)));
+      QVERIFY(data.startsWith("RIFF"));
+      QCOMPARE(data.mid(8, 8), QByteArray("WAVEfmt "));
+      QCOMPARE(qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(data.constData() + 24)), quint32(22050));
+      QCOMPARE(qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(data.constData() + 40)), quint32(4 * 32 * 2 * sizeof(float)));
+      const float* samples = reinterpret_cast<const float*>(data.constData() + 44);
+      QCOMPARE(samples[0], 0.0f);
+      QCOMPARE(samples[3 * 64], 0.375f);
+      f.remove();
+      }
+
+//---------------------------------------------------------
+//   benchmark
+//    cost of a callback mixing a few hundred sine voices
+//---------------------------------------------------------
+
+void TestNullAudio::benchmark()
+      {
+      NullAudio driver(0);
+      QVERIFY(driver.setOptions("frames=256,rate=44100"));
+      QVERIFY(driver.init());
+      std::vector<double> phase(200, 0.0);
+      driver.setSource([&phase](unsigned frames, float* p) {
+            for (size_t v = 0; v < phase.size(); ++v) {
+                  double inc = 2.0 * M_PI * (110.0 + v) / 44100.0;
+                  float* out = p;
+                  for (unsigned i = 0; i < frames; ++i) {
+                        float s = float(sin(phase[v]) * 0.001);
+                        *out++ += s;
+                        *out++ += s;
+                        phase[v] += inc;
+                        }
+                  }
+            });
+      QBENCHMARK {
+            driver.run(10);
+            }
+      qDebug("%s", qPrintable(driver.stats().toString()));
+      }
+
+QTEST_MAIN(TestNullAudio)
+#include "tst_nullaudio.moc"
@@ -35,6 +35,8 @@ class TestSfzLoop : public QObject, public MTest
    private slots:
       void initTestCase();
       void testEnvelopesParsing();
+      void testZoneLookup();
+      void testSharedSample();
       void testLoopAudio();
    public:
       ~TestSfzLoop();
@@ -87,6 +89,40 @@ void TestSfzLoop::testEnvelopesParsing()
       curZone++;
       }
 
+//---------------------------------------------------------
+//   testZoneLookup
+//---------------------------------------------------------
+
+void TestSfzLoop::testZoneLookup()
+      {
+      ZInstrument* i = synth->instrument(0);
+      for (int key = 20; key <= 23; ++key) {
+            const std::vector<Zone*>& zones = i->zones(Trigger::ATTACK, key, 100);
+            QCOMPARE(zones.size(), (size_t) 1);
+            QCOMPARE(zones[0]->keyLo, (char) key);
+            QVERIFY(i->zones(Trigger::RELEASE, key, 100).empty());
+            }
+      QVERIFY(i->zones(Trigger::ATTACK, 19, 100).empty());
+      QVERIFY(i->zones(Trigger::ATTACK, 24, 100).empty());
+      QVERIFY(i->zones(Trigger::ATTACK, -1, 100).empty());
+      QVERIFY(i->ccTriggerZones(64).empty());
+      }
+
+//---------------------------------------------------------
+//   testSharedSample
+//    all regions use the same file, which is read once
+//---------------------------------------------------------
+
+void TestSfzLoop::testSharedSample()
+      {
+      const std::list<Zone*>& zones = synth->instrument(0)->zones();
+      Sample* sample = zones.front()->sample;
+      QVERIFY(sample);
+      for (const Zone* z : zones)
+            QCOMPARE(z->sample, sample);
+      QCOMPARE(synth->loadProgress(), 100);
+      }
+
 void TestSfzLoop::testLoopAudio()
       {
       synth->play(Ms::PlayEvent(ME_PROGRAM, 0, 0, 0));
@@ -0,0 +1,136 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "effects/zita1/zita.h"
+
+using namespace Ms;
+
+static const int FRAMES = 8192;
+static const int STEP   = 16;       // reference has every 16th frame
+
+//---------------------------------------------------------
+//   TestZita
+//---------------------------------------------------------
+
+class TestZita : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      std::vector<float> render(int frames, int chunk) const;
+
+   private slots:
+      void initTestCase();
+      void blockSizes();
+      void reference();
+      void benchmark();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestZita::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   render
+//    a short noise burst followed by the reverb tail,
+//    processed chunk frames at a time
+//---------------------------------------------------------
+
+std::vector<float> TestZita::render(int frames, int chunk) const
+      {
+      ZitaReverb zita;
+      zita.init(44100.0f);
+      zita.set_rtmid(3.0f);
+      zita.set_opmix(0.6f);
+      zita.set_eq1gn(4.0f);
+
+      std::vector<float> in(frames * 2, 0.0f);
+      std::vector<float> out(frames * 2, 0.0f);
+      unsigned s = 12345;
+      for (int i = 0; i < 2000 * 2; ++i) {
+            s = s * 1664525u + 1013904223u;
+            in[i] = (int(s >> 9) - (1 << 22)) / float(1 << 22) * 0.5f;
+            }
+      for (int pos = 0; pos < frames; pos += chunk) {
+            int n = qMin(chunk, frames - pos);
+            zita.process(n, in.data() + pos * 2, out.data() + pos * 2);
+            }
+      return out;
+      }
+
+//---------------------------------------------------------
+//   blockSizes
+//    the output does not depend on how the caller splits
+//    the frames
+//---------------------------------------------------------
+
+void TestZita::blockSizes()
+      {
+      std::vector<float> a = render(FRAMES, FRAMES);
+      for (int chunk : { 1, 3, 64, 1000 }) {
+            std::vector<float> b = render(FRAMES, chunk);
+            for (size_t i = 0; i < a.size(); ++i)
+                  QCOMPARE(b[i], a[i]);
+            }
+      }
+
+//---------------------------------------------------------
+//   reference
+//    compare with the output of the frame by frame
+//    implementation
+//---------------------------------------------------------
+
+void TestZita::reference()
+      {
+      QFile f(root + "/zita/zita-ref.txt");
+      QVERIFY(f.open(QIODevice::ReadOnly | QIODevice::Text));
+      QTextStream ts(&f);
+      std::vector<float> out = render(FRAMES, 256);
+      float peak = 0.0f;
+      for (int i = 0; i < FRAMES; i += STEP) {
+            float l, r;
+            ts >> l >> r;
+            QVERIFY(ts.status() == QTextStream::Ok);
+            QVERIFY(qAbs(out[i * 2] - l) < 1e-5f);
+            QVERIFY(qAbs(out[i * 2 + 1] - r) < 1e-5f);
+            peak = qMax(peak, qAbs(l));
+            }
+      QVERIFY(peak > 0.0f);
+      }
+
+//---------------------------------------------------------
+//   benchmark
+//    one second of stereo noise in blocks of 256 frames
+//---------------------------------------------------------
+
+void TestZita::benchmark()
+      {
+      ZitaReverb zita;
+      zita.init(44100.0f);
+      std::vector<float> in(512);
+      std::vector<float> out(512);
+      for (int i = 0; i < 512; ++i)
+            in[i] = sinf(0.37f * i) * 0.25f;
+      QBENCHMARK {
+            for (int i = 0; i < 44100 / 256; ++i)
+                  zita.process(256, in.data(), out.data());
+            }
+      }
+
+QTEST_MAIN(TestZita)
+#include "tst_zita.moc"
@@ -256,6 +256,17 @@ class NPlayEvent : public PlayEvent {
       int discard() const { return _discard; }
       };
 
+//---------------------------------------------------------
+//   TimedEvent
+//    an event for Synthesizer::processEvents(); frame is
+//    relative to the start of the block
+//---------------------------------------------------------
+
+struct TimedEvent {
+      unsigned frame;
+      NPlayEvent event;
+      };
+
 //---------------------------------------------------------
 //   Event
 //---------------------------------------------------------
@@ -17,11 +17,37 @@
 #include "synthesizergui.h"
 #include "libmscore/xml.h"
 #include "midipatch.h"
+#include "renderpool.h"
 
 namespace Ms {
 
 extern QString dataPath;
 
+//---------------------------------------------------------
+//   processEvents
+//    render n frames and play each event at its frame;
+//    events at or beyond the end of the block are played
+//    after it. This calls process() for every stretch
+//    between two events, synthesizers which can split the
+//    block more cheaply override it.
+//---------------------------------------------------------
+
+void Synthesizer::processEvents(unsigned n, float* p, float* effect1, float* effect2, const std::vector<TimedEvent>& events)
+      {
+      auto at = [](float* buffer, unsigned frame) { return buffer ? buffer + frame * 2 : buffer; };
+      unsigned pos = 0;
+      for (const TimedEvent& e : events) {
+            unsigned frame = qMin(e.frame, n);
+            if (frame > pos) {
+                  process(frame - pos, at(p, pos), at(effect1, pos), at(effect2, pos));
+                  pos = frame;
+                  }
+            play(e.event);
+            }
+      if (n > pos)
+            process(n - pos, at(p, pos), at(effect1, pos), at(effect2, pos));
+      }
+
 //---------------------------------------------------------
 //   MasterSynthesizer
 //---------------------------------------------------------
@@ -29,6 +55,23 @@ extern QString dataPath;
 MasterSynthesizer::MasterSynthesizer()
    : QObject(0)
       {
+      _renderPool = nullptr;
+      }
+
+//---------------------------------------------------------
+//   createRenderPool
+//    let the synthesizers render voices on worker threads;
+//    only worth it for the realtime synthesizer, others
+//    do not spawn any threads
+//---------------------------------------------------------
+
+void MasterSynthesizer::createRenderPool()
+      {
+      if (_renderPool)
+            return;
+      _renderPool = new RenderPool;
+      for (Synthesizer* s : _synthesizer)
+            s->setRenderPool(_renderPool);
       }
 
 //---------------------------------------------------------
@@ -71,6 +114,7 @@ MasterSynthesizer::~MasterSynthesizer()
                   delete e;
             // delete _effect[i];   // _effect takes from _effectList
             }
+      delete _renderPool;
       }
 
 //---------------------------------------------------------
@@ -95,6 +139,49 @@ void MasterSynthesizer::play(const NPlayEvent& event, unsigned syntiIdx)
       _synthesizer[syntiIdx]->play(event);
       }
 
+//---------------------------------------------------------
+//   schedule
+//    play event at framePos of the block rendered by the
+//    next call to process(); events must be scheduled in
+//    the order of framePos
+//    At most MAX_EVENTS are kept per synthesizer and block,
+//    more would allocate on the audio thread. If the list is
+//    full, the pending events and this one are played at
+//    once, in order, like before events were scheduled.
+//---------------------------------------------------------
+
+void MasterSynthesizer::schedule(const NPlayEvent& event, unsigned syntiIdx, unsigned framePos)
+      {
+      if (syntiIdx >= _synthesizer.size())
+            return;
+      Synthesizer* s = _synthesizer[syntiIdx];
+      s->setActive(true);
+      std::vector<TimedEvent>& events = _events[syntiIdx];
+      if (events.size() < MAX_EVENTS) {
+            events.push_back(TimedEvent { framePos, event });
+            return;
+            }
+      for (const TimedEvent& e : events)
+            s->play(e.event);
+      events.clear();
+      s->play(event);
+      }
+
+//---------------------------------------------------------
+//   flushEvents
+//    play the scheduled events at once if a block is not
+//    rendered, so none get lost
+//---------------------------------------------------------
+
+void MasterSynthesizer::flushEvents()
+      {
+      for (unsigned i = 0; i < _synthesizer.size(); ++i) {
+            for (const TimedEvent& e : _events[i])
+                  _synthesizer[i]->play(e.event);
+            _events[i].clear();
+            }
+      }
+
 //---------------------------------------------------------
 //   synthNameToIndex
 //---------------------------------------------------------
@@ -192,6 +279,9 @@ Synthesizer* MasterSynthesizer::synthesizer(const QString& name)
 void MasterSynthesizer::registerSynthesizer(Synthesizer* s)
       {
       _synthesizer.push_back(s);
+      _events.emplace_back();
+      _events.back().reserve(MAX_EVENTS);
+      s->setRenderPool(_renderPool);
       }
 
 //---------------------------------------------------------
@@ -254,23 +344,36 @@ void MasterSynthesizer::setSampleRate(float val)
 
 //---------------------------------------------------------
 //   process
+//    render n frames; events scheduled since the last call
+//    are played at their frames within the block
 //---------------------------------------------------------
 
 void MasterSynthesizer::process(unsigned n, float* p)
       {
-      if (lock2)
+      // not set up yet, effect being changed or block too large
+      if (lock2 || n > MAX_BUFFERSIZE / 2) {
+            flushEvents();
             return;
+            }
       lock1 = true;
       if (lock2) {
             lock1 = false;
+            flushEvents();
             return;
             }
-      // avoid overflow
-      if (n > MAX_BUFFERSIZE / 2)
-            return;
-      for (Synthesizer* s : _synthesizer) {
-            if (s->active())
+      for (unsigned i = 0; i < _synthesizer.size(); ++i) {
+            Synthesizer* s = _synthesizer[i];
+            std::vector<TimedEvent>& events = _events[i];
+            if (!s->active()) {
+                  events.clear();
+                  continue;
+                  }
+            if (events.empty())
                   s->process(n, p, effect1Buffer, effect2Buffer);
+            else {
+                  s->processEvents(n, p, effect1Buffer, effect2Buffer, events);
+                  events.clear();
+                  }
             }
 
       if (_effect[0] && _effect[1]) {
@@ -16,14 +16,15 @@
 #include <atomic>
 #include "effects/effect.h"
 #include "libmscore/synthesizerstate.h"
+#include "synthesizer/event.h"
 
 namespace Ms {
 
 struct MidiPatch;
-class NPlayEvent;
 class Synthesizer;
 class Effect;
 class Xml;
+class RenderPool;
 
 //---------------------------------------------------------
 //   MasterSynthesizer
@@ -43,11 +44,14 @@ class MasterSynthesizer : public QObject {
    public:
       static const int MAX_BUFFERSIZE = 8192;
       static const int MAX_EFFECTS = 2;
+      static const int MAX_EVENTS = 1024;       // per synthesizer and block without allocating
 
    private:
       std::atomic<bool> lock1      { false };
       std::atomic<bool> lock2      { true  };
       std::vector<Synthesizer*> _synthesizer;
+      std::vector<std::vector<TimedEvent>> _events;   // for the next process(), one list per synthesizer
+      RenderPool* _renderPool;
       std::vector<Effect*> _effectList[MAX_EFFECTS];
       Effect* _effect[MAX_EFFECTS]  { nullptr, nullptr };
 
@@ -56,6 +60,7 @@ class MasterSynthesizer : public QObject {
       float effect1Buffer[MAX_BUFFERSIZE];
       float effect2Buffer[MAX_BUFFERSIZE];
       int indexOfEffect(int ab, const QString& name);
+      void flushEvents();
 
    public slots:
       void sfChanged() { emit soundFontChanged(); }
@@ -69,6 +74,7 @@ class MasterSynthesizer : public QObject {
       MasterSynthesizer();
       ~MasterSynthesizer();
       void registerSynthesizer(Synthesizer*);
+      void createRenderPool();
 
       void init();
 
@@ -77,6 +83,7 @@ class MasterSynthesizer : public QObject {
 
       void process(unsigned, float*);
       void play(const NPlayEvent&, unsigned);
+      void schedule(const NPlayEvent&, unsigned syntiIdx, unsigned framePos);
 
       void setMasterTuning(double val);
       double masterTuning() const      { return _masterTuning; }
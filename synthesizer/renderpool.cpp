@@ -0,0 +1,142 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "renderpool.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   RenderPool
+//---------------------------------------------------------
+
+RenderPool::RenderPool(int threads)
+      {
+      threads = qBound(0, threads, MAX_BATCHES - 1);
+      if (threads == 0)
+            return;
+      _buffer = new float[MAX_BATCHES * BUFFERS * MAX_FRAMES * 2];
+      for (int i = 0; i < threads; ++i)
+            _threads.emplace_back(&RenderPool::worker, this);
+      }
+
+RenderPool::~RenderPool()
+      {
+      _quit = true;
+      _wakeup.release(int(_threads.size()));
+      for (std::thread& t : _threads)
+            t.join();
+      delete[] _buffer;
+      }
+
+//---------------------------------------------------------
+//   batches
+//    number of batches to split voices into,
+//    1 means render on the calling thread
+//---------------------------------------------------------
+
+int RenderPool::batches(int voices) const
+      {
+      if (_threads.empty())
+            return 1;
+      return qBound(1, voices / MIN_BATCH_VOICES, int(_threads.size()) + 1);
+      }
+
+//---------------------------------------------------------
+//   runJobs
+//    claim and run jobs of the current generation until
+//    none are left
+//    A job is only claimed by the compare-exchange on
+//    _claim, which fails as soon as run() has closed the
+//    generation, so a late worker never runs a job with the
+//    description of a later call.
+//    Returns true if at least one job was run.
+//---------------------------------------------------------
+
+bool RenderPool::runJobs()
+      {
+      bool ran = false;
+      uint64_t c = _claim.load();
+      for (;;) {
+            uint32_t i = uint32_t(c);
+            if (i == CLOSED)
+                  return ran;
+            Job job    = _job.load();
+            void* ctx  = _context.load();
+            if (int(i) >= _jobs.load())
+                  return ran;
+            if (!_claim.compare_exchange_weak(c, c + 1))
+                  continue;
+            job(ctx, int(i));
+            ++_done;
+            ran = true;
+            c = _claim.load();
+            }
+      }
+
+//---------------------------------------------------------
+//   worker
+//    poll for jobs, spin a little after the last one and
+//    then park until run() wakes the worker
+//---------------------------------------------------------
+
+void RenderPool::worker()
+      {
+      int idle = 0;
+      while (!_quit) {
+            if (runJobs()) {
+                  idle = 0;
+                  continue;
+                  }
+            if (++idle <= SPIN_POLLS) {
+                  std::this_thread::yield();
+                  continue;
+                  }
+            ++_parked;
+            _wakeup.acquire();
+            idle = 0;
+            }
+      }
+
+//---------------------------------------------------------
+//   run
+//    call job(context, i) for i in [0, batches) and wait
+//    until all are done
+//    The calling thread runs every job no worker picked up,
+//    it only waits for jobs which are already running on a
+//    worker. The previous generation is closed before the
+//    job description is replaced.
+//---------------------------------------------------------
+
+void RenderPool::run(int batches, Job job, void* context)
+      {
+      uint64_t generation = (_claim.load() >> 32) + 1;
+      _claim   = (generation << 32) | CLOSED;
+      _job     = job;
+      _context = context;
+      _jobs    = batches;
+      _done    = 0;
+      _claim   = generation << 32;
+
+      // only run() takes workers off _parked, so it cannot drop
+      // below zero; a worker parking right now misses these jobs
+      // and is woken by the next call
+      int wake = qMin(batches - 1, _parked.load());
+      if (wake > 0) {
+            _parked -= wake;
+            _wakeup.release(wake);
+            }
+      runJobs();
+      while (_done.load() != batches)
+            std::this_thread::yield();
+      }
+
+}
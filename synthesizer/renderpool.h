@@ -0,0 +1,153 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2020 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __RENDERPOOL_H__
+#define __RENDERPOOL_H__
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   RenderPool
+//    pre-spawned worker threads which render batches of
+//    synthesizer voices for the audio thread
+//
+//    Jobs are claimed with an atomic counter tagged with the
+//    generation of the run() call, the audio thread takes
+//    part in the work and only waits for jobs a worker has
+//    actually claimed. Idle workers spin briefly and then
+//    park on a semaphore, run() wakes as many parked
+//    workers as the new jobs can use. Every batch
+//    renders into its own scratch buffers, which are summed
+//    in batch order afterwards, so the result does not
+//    depend on the scheduling of the workers. Nothing is
+//    allocated during render().
+//---------------------------------------------------------
+
+class RenderPool {
+   public:
+      static const int MAX_BATCHES      = 8;
+      static const int MIN_BATCH_VOICES = 24;     // below that a batch is not worth a thread
+      static const int MAX_FRAMES       = 4096;
+      static const int BUFFERS          = 3;      // output, effect 1, effect 2
+
+   private:
+      typedef void (*Job)(void* context, int batch);
+
+      static const uint32_t CLOSED      = 0xffffffff;   // job index while a run() is set up
+      static const int SPIN_POLLS       = 64;           // idle polls before a worker parks
+
+      std::vector<std::thread> _threads;
+      QSemaphore _wakeup;
+      std::atomic<int> _parked     { 0 };                 // workers waiting on _wakeup
+      std::atomic<bool> _quit      { false };
+      std::atomic<uint64_t> _claim { uint64_t(CLOSED) };  // generation << 32 | next job
+      std::atomic<int> _done       { 0 };                 // finished jobs of the current generation
+      std::atomic<Job> _job        { nullptr };
+      std::atomic<void*> _context  { nullptr };
+      std::atomic<int> _jobs       { 0 };
+      float* _buffer               { nullptr };   // MAX_BATCHES * BUFFERS * MAX_FRAMES * 2
+
+      void worker();
+      bool runJobs();
+      void run(int batches, Job job, void* context);
+
+      template <class V, class W>
+      struct Batches {
+            const V* voices;
+            int size;
+            int batches;
+            unsigned frames;
+            bool effects;
+            RenderPool* pool;
+            W* write;
+            };
+
+      template <class V, class W>
+      static void renderBatch(void* context, int batch);
+
+   public:
+      RenderPool(int threads = QThread::idealThreadCount() - 1);
+      ~RenderPool();
+
+      int threads() const { return int(_threads.size()); }
+      int batches(int voices) const;
+      float* buffer(int batch, int idx) { return _buffer + (batch * BUFFERS + idx) * MAX_FRAMES * 2; }
+
+      template <class V, class W>
+      bool render(const V& voices, unsigned frames, float* out, float* effect1, float* effect2, W write);
+      };
+
+//---------------------------------------------------------
+//   renderBatch
+//---------------------------------------------------------
+
+template <class V, class W>
+void RenderPool::renderBatch(void* context, int batch)
+      {
+      Batches<V, W>* b = static_cast<Batches<V, W>*>(context);
+      int from = b->size * batch / b->batches;
+      int to   = b->size * (batch + 1) / b->batches;
+      float* out = b->pool->buffer(batch, 0);
+      float* e1  = b->effects ? b->pool->buffer(batch, 1) : nullptr;
+      float* e2  = b->effects ? b->pool->buffer(batch, 2) : nullptr;
+      size_t n   = b->frames * 2 * sizeof(float);
+      memset(out, 0, n);
+      if (b->effects) {
+            memset(e1, 0, n);
+            memset(e2, 0, n);
+            }
+      for (int i = from; i < to; ++i)
+            (*b->write)((*b->voices)[i], b->frames, out, e1, e2);
+      }
+
+//---------------------------------------------------------
+//   render
+//    call write(voice, frames, out, effect1, effect2) for
+//    all voices, spread over the workers; effect buffers
+//    may be null
+//    Returns false if rendering in parallel is not worth
+//    it, nothing has been done then.
+//---------------------------------------------------------
+
+template <class V, class W>
+bool RenderPool::render(const V& voices, unsigned frames, float* out, float* effect1, float* effect2, W write)
+      {
+      int nb = batches(int(voices.size()));
+      if (nb < 2 || frames > MAX_FRAMES)
+            return false;
+      bool effects = effect1 && effect2;
+      Batches<V, W> b { &voices, int(voices.size()), nb, frames, effects, this, &write };
+      run(nb, &renderBatch<V, W>, &b);
+
+      unsigned n = frames * 2;
+      for (int batch = 0; batch < nb; ++batch) {
+            const float* src = buffer(batch, 0);
+            for (unsigned i = 0; i < n; ++i)
+                  out[i] += src[i];
+            if (effects) {
+                  const float* src1 = buffer(batch, 1);
+                  const float* src2 = buffer(batch, 2);
+                  for (unsigned i = 0; i < n; ++i) {
+                        effect1[i] += src1[i];
+                        effect2[i] += src2[i];
+                        }
+                  }
+            }
+      return true;
+      }
+
+}
+#endif
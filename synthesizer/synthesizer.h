@@ -14,11 +14,12 @@
 #define __SYNTHESIZER_H__
 
 #include "libmscore/synthesizerstate.h"
+#include "synthesizer/event.h"
 
 namespace Ms {
 
 struct MidiPatch;
-class PlayEvent;
+class RenderPool;
 class Synth;
 class SynthesizerGui;
 
@@ -44,9 +45,10 @@ class Synthesizer {
    protected:
       float _sampleRate;
       SynthesizerGui* _gui;
+      RenderPool* _renderPool;      // optional workers for process(), owned by MasterSynthesizer
 
    public:
-      Synthesizer() : _active(false) { _gui = 0; }
+      Synthesizer() : _active(false) { _gui = 0; _renderPool = 0; }
       virtual ~Synthesizer() {}
       virtual void init(float sr)    { _sampleRate = sr; }
       float sampleRate() const       { return _sampleRate; }
@@ -63,6 +65,7 @@ class Synthesizer {
       virtual std::vector<SoundFontInfo> soundFontsInfo() const = 0;
 
       virtual void process(unsigned, float*, float*, float*) = 0;
+      virtual void processEvents(unsigned, float*, float*, float*, const std::vector<TimedEvent>&);
       virtual void play(const PlayEvent&) = 0;
 
       virtual const QList<MidiPatch*>& getPatchInfo() const = 0;
@@ -81,6 +84,7 @@ class Synthesizer {
       virtual void allNotesOff(int /*channel*/) {}
 
       virtual SynthesizerGui* gui()  { return _gui; }
+      void setRenderPool(RenderPool* p) { _renderPool = p; }
       };
 
 }
@@ -34,6 +34,43 @@ Channel::Channel(Zerberus* ms, int i)
       _panRightGain = sinf(static_cast<float>(M_PI_2 * 64.0/126.0));
       memset(ctrl, 0, 128 * sizeof(char));
       ctrl[Ms::CTRL_EXPRESSION] = 127;
+      for (int k = 0; k < 128; ++k)
+            _keyVoices[k] = 0;
+      }
+
+//---------------------------------------------------------
+//   addKeyVoice
+//---------------------------------------------------------
+
+void Channel::addKeyVoice(Voice* v)
+      {
+      int k = v->key();
+      if (k < 0 || k > 127)
+            return;
+      v->setNextOnKey(_keyVoices[k]);
+      _keyVoices[k] = v;
+      }
+
+//---------------------------------------------------------
+//   removeKeyVoice
+//---------------------------------------------------------
+
+void Channel::removeKeyVoice(Voice* v)
+      {
+      int k = v->key();
+      if (k < 0 || k > 127)
+            return;
+      Voice* pv = 0;
+      for (Voice* kv = _keyVoices[k]; kv; pv = kv, kv = kv->nextOnKey()) {
+            if (kv == v) {
+                  if (pv)
+                        pv->setNextOnKey(v->nextOnKey());
+                  else
+                        _keyVoices[k] = v->nextOnKey();
+                  v->setNextOnKey(0);
+                  return;
+                  }
+            }
       }
 
 //---------------------------------------------------------
@@ -94,8 +131,14 @@ void Channel::controller(int c, int val)
                   }
             }
 
-      for (Zone *z : instrument()->zones())
-            z->updateCCGain(this);
+      if (c == Ms::CTRL_PROGRAM) {
+            for (Zone *z : instrument()->zones())
+                  z->updateCCGain(this);
+            }
+      else {
+            for (Zone* z : instrument()->ccGainZones(c))
+                  z->updateCCGain(this);
+            }
 //      else
 //            qDebug("Zerberus: ctrl 0x%02x 0x%02x", ctrl, val);
       }
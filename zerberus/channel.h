@@ -15,6 +15,7 @@
 
 class Zerberus;
 class ZInstrument;
+class Voice;
 
 //---------------------------------------------------------
 //   Channel
@@ -28,6 +29,7 @@ class Channel {
       float _panRightGain;
       float _midiVolume;
       char ctrl[128];
+      Voice* _keyVoices[128];       // active voices by key, newest first, linked by Voice::nextOnKey()
 
       int _idx;               // channel index
 #if 0 // yet (?) unused
@@ -49,6 +51,10 @@ class Channel {
       int idx() const            { return _idx; }
       int getCtrl(int CTRL) const;
       void resetCC();
+
+      Voice* keyVoices(int key) const    { return _keyVoices[key]; }
+      void addKeyVoice(Voice*);
+      void removeKeyVoice(Voice*);
       };
 
 
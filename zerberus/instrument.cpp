@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <math.h>
+#include <map>
 #include <QFile>
 #include <QFileInfo>
 #include <QStringList>
@@ -23,9 +24,7 @@
 #include "instrument.h"
 #include "zone.h"
 #include "sample.h"
-
-QByteArray ZInstrument::buf;
-int ZInstrument::idx;
+#include "zerberus.h"
 
 //---------------------------------------------------------
 //   Sample
@@ -37,29 +36,34 @@ Sample::~Sample()
       }
 
 //---------------------------------------------------------
-//   readSample
+//   readSampleFile
 //---------------------------------------------------------
 
-Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
+static QByteArray readSampleFile(const QString& s, MQZipReader* uz)
       {
+      QByteArray buf;
       if (uz) {
-            QVector<MQZipReader::FileInfo> fi = uz->fileInfoList();
-
             buf = uz->fileData(s);
-            if (buf.isEmpty()) {
+            if (buf.isEmpty())
                   printf("Sample::read: cannot read sample data <%s>\n", qPrintable(s));
-                  return 0;
-                  }
             }
       else {
             QFile f(s);
             if (!f.open(QIODevice::ReadOnly)) {
                   printf("Sample::read: open <%s> failed\n", qPrintable(s));
-                  return 0;
+                  return buf;
                   }
             buf = f.readAll();
             }
+      return buf;
+      }
 
+//---------------------------------------------------------
+//   decodeSample
+//---------------------------------------------------------
+
+static Sample* decodeSample(const QString& s, const QByteArray& buf)
+      {
       AudioFile a;
       if (!a.open(buf)) {
             printf("open <%s> failed: %s\n", qPrintable(s), a.error());
@@ -79,7 +83,7 @@ Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
       if (frames != a.readData(data + channel, frames)) {
             qDebug("Sample read failed: %s\n", a.error());
             delete sa;
-            sa = 0;
+            return 0;
             }
       for (int i = 0; i < channel; ++i) {
             data[i]                        = data[channel + i];
@@ -89,6 +93,51 @@ Sample* ZInstrument::readSample(const QString& s, MQZipReader* uz)
       return sa;
       }
 
+//---------------------------------------------------------
+//   readSamples
+//    read and decode the sample files on the global thread
+//    pool; at most MAX_SAMPLE_READERS threads read from disk
+//    at a time. Load progress runs from progress to 100.
+//    samples[i] is 0 if files[i] could not be read.
+//    return false if loading was canceled
+//---------------------------------------------------------
+
+struct SampleJob {
+      QString file;
+      Sample* sample;
+      };
+
+bool ZInstrument::readSamples(const QStringList& files, std::vector<Sample*>& samples, int progress)
+      {
+      QList<SampleJob> jobs;
+      for (const QString& file : files)
+            jobs.append({ file, 0 });
+
+      QSemaphore readers(MAX_SAMPLE_READERS);
+      QAtomicInt done(0);
+      const int total = qMax(files.size(), 1);
+      Zerberus* z = zerberus;
+      QtConcurrent::blockingMap(jobs, [z, &readers, &done, total, progress](SampleJob& job) {
+            if (z->loadWasCanceled())
+                  return;
+            readers.acquire();
+            QByteArray buf = readSampleFile(job.file, 0);
+            readers.release();
+            if (!buf.isEmpty())
+                  job.sample = decodeSample(job.file, buf);
+            int n = done.fetchAndAddOrdered(1) + 1;
+            z->setLoadProgress(progress + (100 - progress) * n / total);
+            });
+
+      samples.clear();
+      for (const SampleJob& job : jobs) {
+            samples.push_back(job.sample);
+            if (job.sample)
+                  _samples.push_back(job.sample);
+            }
+      return !zerberus->loadWasCanceled();
+      }
+
 //---------------------------------------------------------
 //   ZInstrument
 //---------------------------------------------------------
@@ -100,6 +149,7 @@ ZInstrument::ZInstrument(Zerberus* z)
             _setcc[i] = -1;
       _program  = -1;
       _refCount = 0;
+      buildZoneLookup();
       }
 
 //---------------------------------------------------------
@@ -110,6 +160,8 @@ ZInstrument::~ZInstrument()
       {
       for (Zone* z : _zones)
             delete z;
+      for (Sample* s : _samples)
+            delete s;
       }
 
 //---------------------------------------------------------
@@ -122,12 +174,95 @@ bool ZInstrument::load(const QString& path)
       instrumentPath = path;
       QFileInfo fi(path);
       _name = fi.completeBaseName();
+      bool ok = false;
       if (fi.isFile())
-            return loadFromFile(path);
-      if (fi.isDir())
-            return loadFromDir(path);
-      qDebug("not file nor dir %s", qPrintable(path));
-      return false;
+            ok = loadFromFile(path);
+      else if (fi.isDir())
+            ok = loadFromDir(path);
+      else
+            qDebug("not file nor dir %s", qPrintable(path));
+      buildZoneLookup();
+      return ok;
+      }
+
+//---------------------------------------------------------
+//   buildZoneLookup
+//    Precompute for every trigger, key and velocity the
+//    zones which can match, and for every controller the
+//    zones it can trigger or whose gain it changes. Zones
+//    keep their order, as the sequence counters depend on
+//    it. Conditions on controller values, random and
+//    sequence position are still checked by Zone::match()
+//    when triggering.
+//---------------------------------------------------------
+
+void ZInstrument::buildZoneLookup()
+      {
+      std::map<std::vector<Zone*>, int> lists;
+      _zoneLists.assign(1, std::vector<Zone*>());
+      lists[_zoneLists[0]] = 0;
+      auto listIndex = [this, &lists](const std::vector<Zone*>& l) {
+            auto i = lists.find(l);
+            if (i != lists.end())
+                  return i->second;
+            int idx = int(_zoneLists.size());
+            _zoneLists.push_back(l);
+            lists[l] = idx;
+            return idx;
+            };
+
+      _keyVeloZones.assign(KEY_TRIGGERS * 128 * 128, 0);
+      for (int t = 0; t < KEY_TRIGGERS; ++t) {
+            for (int key = 0; key < 128; ++key) {
+                  std::vector<Zone*> keyZones;
+                  for (Zone* z : _zones) {
+                        if (int(z->trigger) == t && z->keyLo <= key && key <= z->keyHi)
+                              keyZones.push_back(z);
+                        }
+                  if (keyZones.empty())
+                        continue;
+                  std::vector<Zone*> l;
+                  std::vector<Zone*> prev;
+                  int idx = 0;
+                  for (int velo = 0; velo < 128; ++velo) {
+                        l.clear();
+                        for (Zone* z : keyZones) {
+                              if (z->veloLo <= velo && velo <= z->veloHi)
+                                    l.push_back(z);
+                              }
+                        if (velo == 0 || l != prev) {
+                              idx  = listIndex(l);
+                              prev = l;
+                              }
+                        _keyVeloZones[(t * 128 + key) * 128 + velo] = idx;
+                        }
+                  }
+            }
+
+      for (int cc = 0; cc < 128; ++cc) {
+            std::vector<Zone*> trigger;
+            std::vector<Zone*> gain;
+            for (Zone* z : _zones) {
+                  if (z->trigger == Trigger::CC && z->onHicc[cc] >= 0 && z->onLocc[cc] <= z->onHicc[cc])
+                        trigger.push_back(z);
+                  if (z->gainOnCC.count(cc))
+                        gain.push_back(z);
+                  }
+            _ccTriggerZones[cc] = listIndex(trigger);
+            _ccGainZones[cc]    = listIndex(gain);
+            }
+      }
+
+//---------------------------------------------------------
+//   zones
+//    zones which can be triggered by a key
+//---------------------------------------------------------
+
+const std::vector<Zone*>& ZInstrument::zones(Trigger t, int key, int velo) const
+      {
+      if (int(t) >= KEY_TRIGGERS || key < 0 || key > 127 || velo < 0 || velo > 127)
+            return _zoneLists[0];
+      return _zoneLists[_keyVeloZones[(int(t) * 128 + key) * 128 + velo]];
       }
 
 //---------------------------------------------------------
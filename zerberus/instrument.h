@@ -14,7 +14,9 @@
 #define __MINSTRUMENT_H__
 
 #include <list>
+#include <vector>
 #include <QString>
+#include <QStringList>
 
 class Zerberus;
 class XmlReader;
@@ -22,6 +24,7 @@ class MQZipReader;
 struct Zone;
 struct SfzRegion;
 class Sample;
+enum class Trigger : char;
 
 //---------------------------------------------------------
 //   ZInstrument
@@ -34,8 +37,21 @@ class ZInstrument {
       int _program;
       QString instrumentPath;
       std::list<Zone*> _zones;
+      std::vector<Sample*> _samples;                  // owned, may be shared by several zones
       int _setcc[128];
 
+      // zone lookup tables, see buildZoneLookup()
+      static const int KEY_TRIGGERS = 4;              // ATTACK, RELEASE, FIRST, LEGATO
+      std::vector<std::vector<Zone*>> _zoneLists;     // distinct candidate lists, 0 is empty
+      std::vector<int> _keyVeloZones;                 // [trigger][key][velocity] -> _zoneLists index
+      int _ccTriggerZones[128];                       // zones triggered by a controller
+      int _ccGainZones[128];                          // zones with a gain depending on a controller
+
+      void buildZoneLookup();
+
+      static const int MAX_SAMPLE_READERS = 4;        // files read at the same time by readSamples()
+
+      bool readSamples(const QStringList& files, std::vector<Sample*>& samples, int progress);
       bool loadFromFile(const QString&);
       bool loadSfz(const QString&);
       bool loadFromDir(const QString&);
@@ -53,13 +69,13 @@ class ZInstrument {
       QString path() const                  { return instrumentPath; }
       const std::list<Zone*>& zones() const { return _zones;  }
       std::list<Zone*>& zones()             { return _zones;  }
-      Sample* readSample(const QString& s, MQZipReader* uz);
       void addZone(Zone* z)                 { _zones.push_back(z); }
-      void addRegion(SfzRegion&);
+      void addRegion(SfzRegion&, Sample*);
       int getSetCC(int v)                   { return _setcc[v]; }
 
-      static QByteArray buf;  // used during read of Sample
-      static int idx;
+      const std::vector<Zone*>& zones(Trigger, int key, int velo) const;
+      const std::vector<Zone*>& ccTriggerZones(int cc) const { return _zoneLists[cc < 0 || cc > 127 ? 0 : _ccTriggerZones[cc]]; }
+      const std::vector<Zone*>& ccGainZones(int cc) const    { return _zoneLists[cc < 0 || cc > 127 ? 0 : _ccGainZones[cc]]; }
       };
 
 #endif
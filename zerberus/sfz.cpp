@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <math.h>
+#include <map>
 #include <QFile>
 #include <QFileInfo>
 #include <QStringList>
@@ -291,8 +292,10 @@ int SfzRegion::readKey(const QString& s, SfzControl c) const
 //   addRegion
 //---------------------------------------------------------
 
-void ZInstrument::addRegion(SfzRegion& r)
+void ZInstrument::addRegion(SfzRegion& r, Sample* sample)
       {
+      if (!sample)
+            return;
       for (int i = 0; i < 128; ++i) {
             if (r.on_locc[i] != -1 || r.on_hicc[i] != -1) {
                   r.trigger = Trigger::CC;
@@ -300,19 +303,16 @@ void ZInstrument::addRegion(SfzRegion& r)
                   }
             }
       Zone* z = new Zone;
-      z->sample = readSample(r.sample, 0);
-      if (z->sample) {
-            //qDebug("Sample Loop - start %ll, end %ll, mode %d", z->sample->loopStart(), z->sample->loopEnd(), z->sample->loopMode());
-            // if there is no opcode defining loop ranges, use sample definitions as fallback (according to spec)
-            if (r.loopStart == -1)
-                  r.loopStart = z->sample->loopStart();
-            if (r.loopEnd == -1)
-                  r.loopEnd = z->sample->loopEnd();
-            }
+      z->sample = sample;
+      // if there is no opcode defining loop ranges, use sample definitions as fallback (according to spec)
+      if (r.loopStart == -1)
+            r.loopStart = sample->loopStart();
+      if (r.loopEnd == -1)
+            r.loopEnd = sample->loopEnd();
       r.setZone(z);
-      if (z->sample)
-            addZone(z);
+      addZone(z);
       }
+
 //---------------------------------------------------------
 //   readLongLong
 //---------------------------------------------------------
@@ -585,6 +585,10 @@ QStringList readFile(QString const fn)
             return list;
       }
 
+// share of the load progress spent parsing, the rest is
+// spent reading samples
+static const int PARSE_PROGRESS = 10;
+
 //---------------------------------------------------------
 //   loadSfz
 //---------------------------------------------------------
@@ -701,17 +705,18 @@ bool ZInstrument::loadSfz(const QString& s)
 
       bool groupMode = false;
       bool globMode = false;
+      std::vector<SfzRegion> regions;
       zerberus->setLoadProgress(0);
 
       for (int idx1 = 0; idx1 < fileContents.size(); idx1++) {
             QString curLine = fileContents[idx1];
-            zerberus->setLoadProgress(((qreal) idx1 * 100) /  (qreal) total);
+            zerberus->setLoadProgress(((qreal) idx1 * PARSE_PROGRESS) /  (qreal) total);
 
             if (zerberus->loadWasCanceled())
                   return false;
             if (curLine.startsWith("<global>")) {
                   if (!globMode && !groupMode && !r.isEmpty())
-                        addRegion(r);
+                        regions.push_back(r);
                   glob.init(path);
                   g.init(path); // global also resets group
                   r.init(path);
@@ -719,7 +724,7 @@ bool ZInstrument::loadSfz(const QString& s)
                   }
             if (curLine.startsWith("<group>")) {
                   if (!groupMode && !globMode && !r.isEmpty())
-                        addRegion(r);
+                        regions.push_back(r);
                   g.init(path);
                   if (globMode) {
                         glob = r;
@@ -743,7 +748,7 @@ bool ZInstrument::loadSfz(const QString& s)
                         }
                   else {
                         if (!r.isEmpty())
-                              addRegion(r);
+                              regions.push_back(r);
                         r = g;  // initialize next region with group values
                         }
                   curLine = curLine.mid(8);
@@ -772,9 +777,23 @@ bool ZInstrument::loadSfz(const QString& s)
       for (int i = 0; i < 128; i++)
             _setcc[i] = c.set_cc[i];
 
-      zerberus->setLoadProgress(100);
       if (!groupMode && !globMode && !r.isEmpty())
-            addRegion(r);
+            regions.push_back(r);
+
+      // read every sample file once, even if several regions use it
+      QStringList files;
+      std::map<QString, int> fileIndex;
+      for (const SfzRegion& region : regions) {
+            if (fileIndex.insert(std::make_pair(region.sample, files.size())).second)
+                  files.append(region.sample);
+            }
+      std::vector<Sample*> samples;
+      if (!readSamples(files, samples, PARSE_PROGRESS))
+            return false;
+      for (SfzRegion& region : regions)
+            addRegion(region, samples[fileIndex[region.sample]]);
+
+      zerberus->setLoadProgress(100);
       return true;
       }
 
@@ -164,7 +164,7 @@ void Voice::start(Channel* c, int key, int v, const Zone* zone, double durSinceN
       envelopes[V1Envelopes::SUSTAIN].setTable(Envelope::egLin);
       if (trigger == Trigger::RELEASE || trigger == Trigger::CC) {
             // Sample is played on noteoff. We need to stop the voice when it's done. Set the sustain duration accordingly.
-            //in ZInstrument::readSample we create sample data array using frames*channels
+            //in decodeSample() (instrument.cpp) we create sample data array using frames*channels
             //so no need to devide by number of channels here, otherwise it reduces duration of samples by (Number of Channels)
             double sampleDur = ((double) z->sample->frames() / z->sample->sampleRate()) * 1000; // in ms
             double scaledSampleDur = sampleDur / (phaseIncr.data / 256.0);
@@ -117,6 +117,7 @@ enum V1Envelopes : int {
 
 class Voice {
       Voice* _next;
+      Voice* _nextOnKey = 0;        // next active voice of the same channel and key
       Zerberus* _zerberus;
 
       VoiceState _state = VoiceState::OFF;
@@ -152,6 +153,8 @@ class Voice {
       Voice(Zerberus*);
       Voice* next() const         { return _next; }
       void setNext(Voice* v)      { _next = v; }
+      Voice* nextOnKey() const    { return _nextOnKey; }
+      void setNextOnKey(Voice* v) { _nextOnKey = v; }
 
       void start(Channel* channel, int key, int velo, const Zone*, double durSinceNoteOn);
       void updateEnvelopes();
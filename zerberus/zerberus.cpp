@@ -13,6 +13,7 @@
 #include "mscore/preferences.h"
 #include "synthesizer/event.h"
 #include "synthesizer/midipatch.h"
+#include "synthesizer/renderpool.h"
 
 #include "zerberus.h"
 #include "zerberusgui.h"
@@ -49,6 +50,7 @@ Zerberus::Zerberus()
             }
       
       freeVoices.init(this);
+      renderVoices.reserve(MAX_VOICES);
       for (int i = 0; i < MAX_CHANNEL; ++i)
             _channel[i] = new Channel(this, i);
       busy = true;      // no sf loaded yet
@@ -98,7 +100,8 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
       {
       ZInstrument* i = channel->instrument();
       double random = (double) rand() / (double) RAND_MAX;
-      for (Zone* z : i->zones()) {
+      const std::vector<Zone*>& zones = trigger == Trigger::CC ? i->ccTriggerZones(cc) : i->zones(trigger, key, velo);
+      for (Zone* z : zones) {
             if (z->match(channel, key, velo, trigger, random, cc, ccVal)) {
                   //
                   // handle offBy voices
@@ -124,6 +127,7 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
                   voice->start(channel, key, velo, z, durSinceNoteOn);
                   voice->setNext(activeVoices);
                   activeVoices = voice;
+                  channel->addKeyVoice(voice);
                   }
             }
       }
@@ -134,11 +138,10 @@ void Zerberus::trigger(Channel* channel, int key, int velo, Trigger trigger, int
 
 void Zerberus::processNoteOff(Channel* cp, int key)
       {
-      for (Voice* v = activeVoices; v; v = v->next()) {
-            if ((v->channel() == cp)
-               && (v->key() == key)
-               && (v->loopMode() != LoopMode::ONE_SHOT)
-               ) {
+      if (key < 0 || key > 127)
+            return;
+      for (Voice* v = cp->keyVoices(key); v; v = v->nextOnKey()) {
+            if (v->loopMode() != LoopMode::ONE_SHOT) {
                   if (cp->sustain() < 0x40 && !v->isStopped()) {
                         v->stop();
                         double durSinceNoteOn = v->getSamplesSinceStart() / sampleRate();
@@ -158,13 +161,13 @@ void Zerberus::processNoteOff(Channel* cp, int key)
 
 void Zerberus::processNoteOn(Channel* cp, int key, int velo)
       {
-      for (Voice* v = activeVoices; v; v = v->next()) {
-            if (v->channel() == cp && v->key() == key) {
-                  if (v->isSustained()) {
+      if (key < 0 || key > 127)
+            return;
+      for (Voice* v = cp->keyVoices(key); v; v = v->nextOnKey()) {
+            if (v->isSustained()) {
 //if (v->isPlaying())
 //printf("retrigger (stop) %p\n", v);
-                        v->stop(100);     // fast stop
-                        }
+                  v->stop(100);     // fast stop
                   }
             }
       trigger(cp, key, velo, Trigger::ATTACK, -1, -1, 0);
@@ -203,7 +206,8 @@ void Zerberus::play(const Ms::PlayEvent& event)
 
             case Ms::ME_CONTROLLER:
                   cp->controller(event.dataA(), event.dataB());
-                  trigger(cp, -1, -1, Trigger::CC, event.dataA(), event.dataB(), 0);
+                  if (event.dataA() != Ms::CTRL_PROGRAM)
+                        trigger(cp, -1, -1, Trigger::CC, event.dataA(), event.dataB(), 0);
                   break;
 
             default:
@@ -221,15 +225,25 @@ void Zerberus::process(unsigned frames, float* p, float*, float*)
       {
       if (busy)
             return;
+      bool parallel = false;
+      if (_renderPool) {
+            renderVoices.clear();
+            for (Voice* v = activeVoices; v; v = v->next())
+                  renderVoices.push_back(v);
+            parallel = _renderPool->render(renderVoices, frames, p, nullptr, nullptr,
+               [](Voice* v, unsigned n, float* out, float*, float*) { v->process(n, out); });
+            }
       Voice* v = activeVoices;
       Voice* pv = 0;
       while (v) {
-            v->process(frames, p);
+            if (!parallel)
+                  v->process(frames, p);
             if (v->isOff()) {
                   if (pv)
                         pv->setNext(v->next());
                   else
                         activeVoices = v->next();
+                  v->channel()->removeKeyVoice(v);
                   freeVoices.push(v);
                   }
             else
@@ -86,8 +86,9 @@ class Zerberus : public Ms::Synthesizer {
       int allocatedVoices = 0;
       VoiceFifo freeVoices;
       Voice* activeVoices = 0;
-      int _loadProgress = 0;
-      bool _loadWasCanceled = false;
+      std::vector<Voice*> renderVoices;   // snapshot of activeVoices for parallel rendering
+      std::atomic<int> _loadProgress { 0 };   // set by the sample loader threads
+      std::atomic<bool> _loadWasCanceled { false };   // set by the gui, read by the loader
 
       QMutex mutex;
 
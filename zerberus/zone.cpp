@@ -29,15 +29,6 @@ Zone::Zone()
             }
       }
 
-//---------------------------------------------------------
-//   Zone
-//---------------------------------------------------------
-
-Zone::~Zone()
-      {
-      delete sample;
-      }
-
 //---------------------------------------------------------
 //   match
 //---------------------------------------------------------
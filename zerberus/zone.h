@@ -54,7 +54,7 @@ enum class FilterType {
 //---------------------------------------------------------
 
 struct Zone {
-      Sample* sample = 0;
+      Sample* sample = 0;     // owned by ZInstrument
       long long offset  = 0; //[0, 4294967295]
       int  seq     = 0;
       int seqLen   = 0;
@@ -117,7 +117,6 @@ struct Zone {
       bool useCC = false;
 
       Zone();
-      ~Zone();
       bool match(Channel*, int key, int velo, Trigger, double rand, int cc, int ccVal);
       void updateCCGain(Channel* c);
       };